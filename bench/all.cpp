@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "batch.h"
+#include "bench_utils.h"
+#include "utils.h"
+
+/*
+ * aoc_all runs every registered part once, all of them at the same time on
+ * the pool of the global ExecutionContext, and reports when each one ran
+ * and on which worker. The makespan is the wall time from the first task
+ * starting to the last one finishing.
+ *
+ * With --batch it instead runs one day over a directory or manifest of
+ * inputs, see batch.h.
+ */
+
+namespace {
+struct Options {
+  ExecutionSettings execution = ExecutionSettings::from_env();
+  std::string input_root = AOC_SOURCE_DIR;
+  int day = 0;
+  int part = 0;
+  std::string batch_source;
+  std::string csv_path;
+  std::string json_path;
+};
+
+struct Task {
+  const Solution *solution;
+  std::string input;
+  std::string answer{};
+  int worker = -1;
+  std::uint64_t start_ns = 0;
+  std::uint64_t end_ns = 0;
+};
+
+void usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s [--threads N] [--affinity LIST] [--deterministic] [--inputs DIR] [--day N] [--part N]\n"
+               "       %s --batch DIR|MANIFEST --day N [--part N] [--threads N] [--csv FILE] [--json FILE]\n"
+               "  Inputs are read from DIR/dayN/<input>, DIR defaults to the source tree.\n"
+               "  --threads, --affinity and --deterministic override AOC_THREADS,\n"
+               "  AOC_AFFINITY and AOC_DETERMINISTIC, LIST is a cpu list like 0-3,8.\n"
+               "  --batch solves every file of DIR, or every path listed in MANIFEST, with\n"
+               "  at most N inputs in flight and writes per input timings to FILE.\n",
+               name, name);
+}
+
+[[nodiscard]] bool parse_options(int argc, char *argv[], Options &options) {
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    if (arg == "--deterministic") {
+      options.execution.deterministic = true;
+      continue;
+    }
+    if (idx + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++idx];
+
+    if (arg == "--threads") {
+      options.execution.threads = std::max<size_t>(1, parse_number<size_t>(value));
+    } else if (arg == "--affinity") {
+      if (!parse_cpu_list(value, options.execution.cpus)) {
+        return false;
+      }
+    } else if (arg == "--inputs") {
+      options.input_root = value;
+    } else if (arg == "--day") {
+      options.day = parse_number<int>(value);
+    } else if (arg == "--part") {
+      options.part = parse_number<int>(value);
+    } else if (arg == "--batch") {
+      options.batch_source = value;
+    } else if (arg == "--csv") {
+      options.csv_path = value;
+    } else if (arg == "--json") {
+      options.json_path = value;
+    } else {
+      return false;
+    }
+  }
+  /* A batch is always one day, and the output files only exist for batches */
+  if (options.batch_source.empty()) {
+    return options.csv_path.empty() && options.json_path.empty();
+  }
+  return options.day != 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  Profiler::instance().set_report_at_exit(false);
+  ExecutionContext::configure_global(options.execution);
+  auto &context = ExecutionContext::global();
+
+  if (!options.batch_source.empty()) {
+    return run_batch({options.batch_source, options.day, options.part, context.threads(), options.csv_path,
+                      options.json_path});
+  }
+
+  std::vector<Task> tasks;
+  for (const auto &solution : SolutionRegistry::instance().solutions()) {
+    if ((options.day != 0 && solution.day != options.day) || (options.part != 0 && solution.part != options.part)) {
+      continue;
+    }
+    std::string input = input_path(options.input_root, solution);
+    if (file_size(input) < 0) {
+      std::fprintf(stderr, "day%d part %d: no input at %s\n", solution.day, solution.part, input.c_str());
+      continue;
+    }
+    tasks.push_back({&solution, std::move(input)});
+  }
+
+  auto run_start = std::chrono::steady_clock::now();
+  auto since_start = [run_start] {
+    return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - run_start).count());
+  };
+
+  std::uint64_t makespan_ns = 0;
+  {
+    SilencedStdout silenced;
+    auto &pool = context.pool();
+    for (auto &task : tasks) {
+      pool.submit([&task, &since_start] {
+        task.worker = ThreadPool::current_worker();
+        task.start_ns = since_start();
+        task.answer = task.solution->solve(task.input);
+        task.end_ns = since_start();
+      });
+    }
+    pool.wait();
+    makespan_ns = since_start();
+  }
+
+  std::printf("%-6s %-5s %6s %12s %12s  %-16s %s\n", "day", "part", "worker", "start", "duration", "answer", "status");
+  bool all_ok = true;
+  std::uint64_t total_ns = 0;
+  for (const auto &task : tasks) {
+    std::string status = "unchecked";
+    if (!task.solution->expected.empty()) {
+      if (task.answer == task.solution->expected) {
+        status = "ok";
+      } else {
+        status = "MISMATCH, expected " + std::string(task.solution->expected);
+        all_ok = false;
+      }
+    }
+    total_ns += task.end_ns - task.start_ns;
+
+    std::string day_name = "day" + std::to_string(task.solution->day);
+    std::printf("%-6s %-5d %6d %12s %12s  %-16s %s\n", day_name.c_str(), task.solution->part, task.worker,
+                format_duration(task.start_ns).c_str(), format_duration(task.end_ns - task.start_ns).c_str(),
+                task.answer.c_str(), status.c_str());
+  }
+
+  std::printf("\n%zu tasks on %zu threads%s: makespan %s, sum of task times %s", tasks.size(), context.threads(),
+              context.deterministic() ? " (deterministic)" : "",
+              format_duration(makespan_ns).c_str(), format_duration(total_ns).c_str());
+  if (makespan_ns > 0) {
+    std::printf(", %.2fx", static_cast<double>(total_ns) / static_cast<double>(makespan_ns));
+  }
+  std::printf("\n");
+  context.print_busy_time(stdout, makespan_ns);
+
+  return all_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,202 @@
+#!/usr/bin/env python
+"""Stores aoc_bench --json runs as baselines and compares new runs against them.
+
+Baselines live in one JSON store keyed by git revision, then by
+"dayN/partP/input_bytes", so runs on inputs of different size never get
+compared with each other.
+
+    aoc_bench --json run.json
+    baseline.py save run.json
+    ... change something, rebuild ...
+    aoc_bench --json run.json
+    baseline.py compare run.json
+
+compare runs a two-sided Mann-Whitney U test on the raw samples and flags a
+regression when the difference is significant and the median slowed down by
+more than the threshold. The exit status is 1 when anything regressed.
+"""
+
+import argparse
+import json
+import math
+import sys
+from functools import lru_cache
+from pathlib import Path
+from statistics import median
+from typing import Any
+
+DEFAULT_STORE = Path(__file__).resolve().parent / "baselines.json"
+
+Samples = list[int]
+Store = dict[str, Any]
+
+
+def result_key(result: dict[str, Any]) -> str:
+    return f"day{result['day']}/part{result['part']}/{result['input_bytes']}"
+
+
+def load_json(path: Path) -> Any:
+    with path.open() as f:
+        return json.load(f)
+
+
+def load_store(path: Path) -> Store:
+    if not path.exists():
+        return {"order": [], "baselines": {}}
+    return load_json(path)
+
+
+@lru_cache(maxsize=None)
+def u_distribution(n1: int, n2: int, u: int) -> int:
+    """Number of orderings of n1 + n2 distinct values whose U statistic is u."""
+    if u < 0 or u > n1 * n2:
+        return 0
+    if n1 == 0 or n2 == 0:
+        return 1 if u == 0 else 0
+    return u_distribution(n1 - 1, n2, u - n2) + u_distribution(n1, n2 - 1, u)
+
+
+def mann_whitney_u(a: Samples, b: Samples) -> tuple[float, float]:
+    """Two-sided Mann-Whitney U test, returns (U for a, p-value)."""
+    n1, n2 = len(a), len(b)
+    combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+
+    # Average ranks over ties, remembering tie sizes for the variance correction
+    ranks = [0.0] * len(combined)
+    tie_sizes: list[int] = []
+    idx = 0
+    while idx < len(combined):
+        end = idx
+        while end + 1 < len(combined) and combined[end + 1][0] == combined[idx][0]:
+            end += 1
+        for r in range(idx, end + 1):
+            ranks[r] = (idx + end) / 2 + 1
+        tie_sizes.append(end - idx + 1)
+        idx = end + 1
+
+    rank_sum_a = sum(rank for rank, (_, group) in zip(ranks, combined) if group == 0)
+    u_a = rank_sum_a - n1 * (n1 + 1) / 2
+    has_ties = any(t > 1 for t in tie_sizes)
+
+    if not has_ties and n1 * n2 <= 400:
+        total = math.comb(n1 + n2, n1)
+        u = int(u_a)
+        lower = sum(u_distribution(n1, n2, k) for k in range(0, u + 1)) / total
+        upper = sum(u_distribution(n1, n2, k) for k in range(u, n1 * n2 + 1)) / total
+        return u_a, min(1.0, 2 * min(lower, upper))
+
+    n = n1 + n2
+    mean_u = n1 * n2 / 2
+    tie_term = sum(t ** 3 - t for t in tie_sizes) / (n * (n - 1)) if n > 1 else 0
+    variance = n1 * n2 / 12 * ((n + 1) - tie_term)
+    if variance <= 0:
+        return u_a, 1.0
+    z = (abs(u_a - mean_u) - 0.5) / math.sqrt(variance)
+    return u_a, min(1.0, math.erfc(max(z, 0) / math.sqrt(2)))
+
+
+def format_ns(ns: float) -> str:
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3f} {unit}"
+    return f"{ns:.0f} ns"
+
+
+def save(args: argparse.Namespace) -> int:
+    run = load_json(args.run)
+    rev = args.rev or run.get("git_rev", "unknown")
+    store = load_store(args.store)
+
+    baseline = store["baselines"].setdefault(rev, {})
+    for result in run["results"]:
+        baseline[result_key(result)] = {
+            "answer": result["answer"],
+            "samples_ns": result["samples_ns"],
+        }
+    if rev in store["order"]:
+        store["order"].remove(rev)
+    store["order"].append(rev)
+
+    args.store.write_text(json.dumps(store, indent=1) + "\n")
+    print(f"Saved {len(run['results'])} results as baseline {rev} in {args.store}")
+    return 0
+
+
+def list_baselines(args: argparse.Namespace) -> int:
+    store = load_store(args.store)
+    for rev in store["order"]:
+        print(f"{rev}: {len(store['baselines'][rev])} results")
+    return 0
+
+
+def compare(args: argparse.Namespace) -> int:
+    run = load_json(args.run)
+    store = load_store(args.store)
+    if not store["order"]:
+        print(f"No baselines in {args.store}", file=sys.stderr)
+        return 2
+    rev = args.rev or store["order"][-1]
+    if rev not in store["baselines"]:
+        print(f"No baseline {rev} in {args.store}", file=sys.stderr)
+        return 2
+    baseline = store["baselines"][rev]
+
+    print(f"Comparing {run.get('git_rev', 'unknown')} against baseline {rev}")
+    print(f"{'key':<28} {'baseline':>12} {'current':>12} {'change':>8} {'p':>8}  verdict")
+
+    regressions = 0
+    for result in run["results"]:
+        key = result_key(result)
+        if key not in baseline:
+            print(f"{key:<28} {'-':>12} {format_ns(median(result['samples_ns'])):>12} {'':>8} {'':>8}  new")
+            continue
+
+        old: Samples = baseline[key]["samples_ns"]
+        new: Samples = result["samples_ns"]
+        old_median, new_median = median(old), median(new)
+        change = (new_median - old_median) / old_median if old_median > 0 else 0.0
+        _, p = mann_whitney_u(new, old)
+
+        verdict = "~"
+        if p < args.alpha and change > args.threshold:
+            verdict = "REGRESSION"
+            regressions += 1
+        elif p < args.alpha and change < -args.threshold:
+            verdict = "faster"
+        if baseline[key]["answer"] != result["answer"]:
+            verdict += f" (answer changed from {baseline[key]['answer']})"
+
+        print(f"{key:<28} {format_ns(old_median):>12} {format_ns(new_median):>12} "
+              f"{change * 100:>+7.1f}% {p:>8.4f}  {verdict}")
+
+    return 1 if regressions > 0 else 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--store", type=Path, default=DEFAULT_STORE, help="baseline store (default: %(default)s)")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    save_parser = commands.add_parser("save", help="store an aoc_bench --json run as a baseline")
+    save_parser.add_argument("run", type=Path)
+    save_parser.add_argument("--rev", help="baseline name, defaults to the run's git revision")
+    save_parser.set_defaults(func=save)
+
+    list_parser = commands.add_parser("list", help="list stored baselines, oldest first")
+    list_parser.set_defaults(func=list_baselines)
+
+    compare_parser = commands.add_parser("compare", help="compare a run against a baseline")
+    compare_parser.add_argument("run", type=Path)
+    compare_parser.add_argument("--rev", help="baseline to compare against, defaults to the last one saved")
+    compare_parser.add_argument("--threshold", type=float, default=0.05,
+                                help="relative median change treated as meaningful (default: %(default)s)")
+    compare_parser.add_argument("--alpha", type=float, default=0.01,
+                                help="significance level for the Mann-Whitney U test (default: %(default)s)")
+    compare_parser.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
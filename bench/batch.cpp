@@ -0,0 +1,302 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bench_utils.h"
+#include "utils.h"
+
+namespace {
+namespace fs = std::filesystem;
+
+struct BatchInput {
+  std::string path;
+  std::int64_t bytes;
+};
+
+struct BatchResult {
+  const BatchInput *input;
+  const Solution *solution;
+  std::string answer{};
+  std::string status{};
+  int worker = -1;
+  bool prefetched = false;
+  std::uint64_t start_ns = 0;
+  std::uint64_t end_ns = 0;
+};
+
+/*
+ * The mapping of one input made ahead of time. Whichever comes first, the
+ * prefetch or the job solving the input, marks the other as unnecessary.
+ */
+struct PrefetchSlot {
+  std::mutex mutex;
+  std::unique_ptr<FileHelper> file;
+  bool taken = false;
+};
+
+/* Every regular file of a directory by name, or every line of a manifest */
+[[nodiscard]] bool list_inputs(const std::string &source, std::vector<BatchInput> &inputs) {
+  std::error_code error;
+  std::vector<std::string> paths;
+  if (fs::is_directory(source, error)) {
+    for (const auto &entry : fs::directory_iterator(source, error)) {
+      if (entry.is_regular_file(error)) {
+        paths.push_back(entry.path().string());
+      }
+    }
+    if (error) {
+      std::fprintf(stderr, "%s: %s\n", source.c_str(), error.message().c_str());
+      return false;
+    }
+    std::sort(paths.begin(), paths.end());
+  } else {
+    std::ifstream manifest{source};
+    if (!manifest) {
+      std::perror(source.c_str());
+      return false;
+    }
+    /* Relative entries are relative to the manifest, # starts a comment */
+    fs::path base = fs::path(source).parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+      std::string_view entry = line;
+      entry.remove_prefix(std::min(entry.find_first_not_of(" \t\r"), entry.size()));
+      entry = entry.substr(0, entry.find_last_not_of(" \t\r") + 1);
+      if (entry.empty() || entry.front() == '#') {
+        continue;
+      }
+      fs::path path{entry};
+      paths.push_back(path.is_absolute() ? path.string() : (base / path).string());
+    }
+  }
+
+  for (auto &path : paths) {
+    std::int64_t bytes = file_size(path);
+    if (bytes < 0) {
+      std::fprintf(stderr, "%s: not a regular file, skipped\n", path.c_str());
+      continue;
+    }
+    inputs.push_back({std::move(path), bytes});
+  }
+  return true;
+}
+
+void write_csv_field(std::FILE *out, std::string_view text) {
+  if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+    std::fwrite(text.data(), 1, text.size(), out);
+    return;
+  }
+  std::fputc('"', out);
+  for (char c : text) {
+    if (c == '"') {
+      std::fputc('"', out);
+    }
+    std::fputc(c, out);
+  }
+  std::fputc('"', out);
+}
+
+[[nodiscard]] bool write_csv(const std::string &path, const std::vector<BatchResult> &results) {
+  std::FILE *out = std::fopen(path.c_str(), "w");
+  if (out == nullptr) {
+    std::perror(path.c_str());
+    return false;
+  }
+  std::fprintf(out, "input,day,part,input_bytes,worker,prefetched,start_ns,duration_ns,answer,status\n");
+  for (const auto &result : results) {
+    write_csv_field(out, result.input->path);
+    std::fprintf(out, ",%d,%d,%ld,%d,%d,%lu,%lu,", result.solution->day, result.solution->part, result.input->bytes,
+                 result.worker, result.prefetched ? 1 : 0, result.start_ns, result.end_ns - result.start_ns);
+    write_csv_field(out, result.answer);
+    std::fputc(',', out);
+    write_csv_field(out, result.status);
+    std::fputc('\n', out);
+  }
+  return std::fclose(out) == 0;
+}
+
+[[nodiscard]] bool write_json(const std::string &path, const BatchOptions &options, std::uint64_t wall_ns,
+                              const std::vector<BatchResult> &results) {
+  std::FILE *out = std::fopen(path.c_str(), "w");
+  if (out == nullptr) {
+    std::perror(path.c_str());
+    return false;
+  }
+  std::fprintf(out, "{\n  \"source\": ");
+  write_json_string(out, options.source);
+  std::fprintf(out, ",\n  \"day\": %d,\n  \"jobs\": %zu,\n  \"wall_ns\": %lu,\n  \"results\": [", options.day,
+               options.jobs, wall_ns);
+  for (size_t idx = 0; idx < results.size(); ++idx) {
+    const auto &result = results[idx];
+    std::fprintf(out, "%s\n    {\"input\": ", idx == 0 ? "" : ",");
+    write_json_string(out, result.input->path);
+    std::fprintf(out,
+                 ", \"part\": %d, \"input_bytes\": %ld, \"worker\": %d, \"prefetched\": %s, \"start_ns\": %lu, "
+                 "\"duration_ns\": %lu, \"answer\": ",
+                 result.solution->part, result.input->bytes, result.worker, result.prefetched ? "true" : "false",
+                 result.start_ns, result.end_ns - result.start_ns);
+    write_json_string(out, result.answer);
+    std::fprintf(out, ", \"status\": ");
+    write_json_string(out, result.status);
+    std::fprintf(out, "}");
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+  return std::fclose(out) == 0;
+}
+} // namespace
+
+int run_batch(const BatchOptions &options) {
+  std::vector<const Solution *> parts;
+  for (const auto &solution : SolutionRegistry::instance().solutions()) {
+    if (solution.day == options.day && (options.part == 0 || solution.part == options.part)) {
+      parts.push_back(&solution);
+    }
+  }
+  if (parts.empty()) {
+    std::fprintf(stderr, "no registered solution for day%d\n", options.day);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<BatchInput> inputs;
+  if (!list_inputs(options.source, inputs)) {
+    return EXIT_FAILURE;
+  }
+  if (inputs.empty()) {
+    std::fprintf(stderr, "%s: no inputs\n", options.source.c_str());
+    return EXIT_FAILURE;
+  }
+
+  /* Results are laid out input by input, so each job writes only its own rows */
+  std::vector<BatchResult> results;
+  results.reserve(inputs.size() * parts.size());
+  for (const auto &input : inputs) {
+    for (const auto *solution : parts) {
+      results.push_back({&input, solution});
+    }
+  }
+
+  auto run_start = std::chrono::steady_clock::now();
+  auto since_start = [run_start] {
+    return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - run_start).count());
+  };
+
+  auto &context = ExecutionContext::global();
+  size_t jobs = std::max<size_t>(1, std::min({options.jobs, context.threads(), inputs.size()}));
+  std::vector<PrefetchSlot> slots(inputs.size());
+  std::atomic<size_t> next_input{0};
+
+  auto prefetch = [&](size_t index) {
+    if (index >= inputs.size()) {
+      return;
+    }
+    auto file = std::make_unique<FileHelper>(inputs[index].path);
+    file->will_need();
+    std::lock_guard lock(slots[index].mutex);
+    if (!slots[index].taken) {
+      slots[index].file = std::move(file);
+    }
+  };
+
+  /*
+   * Each job takes inputs in order until none are left. Inputs are handed
+   * out one at a time, so the one a job gets after the current one is about
+   * jobs places further on, that is the one it prefetches. Deterministic
+   * runs deal the inputs out up front instead, job j taking j, j + jobs and
+   * so on, so the same job solves the same inputs every time.
+   */
+  auto run_job = [&](size_t job) {
+    auto next = [&](size_t index) { return context.deterministic() ? index + jobs : next_input++; };
+    for (size_t index = context.deterministic() ? job : next_input++; index < inputs.size(); index = next(index)) {
+      std::unique_ptr<FileHelper> file;
+      {
+        std::lock_guard lock(slots[index].mutex);
+        slots[index].taken = true;
+        file = std::move(slots[index].file);
+      }
+      prefetch(index + jobs);
+
+      for (size_t part = 0; part < parts.size(); ++part) {
+        auto &result = results[index * parts.size() + part];
+        result.worker = ThreadPool::current_worker();
+        result.prefetched = file != nullptr;
+        result.start_ns = since_start();
+        try {
+          result.answer = result.solution->solve(result.input->path);
+          result.status = "ok";
+        } catch (const std::exception &error) {
+          result.status = std::string("error: ") + error.what();
+        }
+        result.end_ns = since_start();
+      }
+    }
+  };
+
+  std::uint64_t wall_ns = 0;
+  {
+    SilencedStdout silenced;
+    auto &pool = context.pool();
+    for (size_t job = 0; job < jobs; ++job) {
+      pool.submit([&run_job, job] { run_job(job); });
+    }
+    pool.wait();
+    wall_ns = since_start();
+  }
+
+  std::uint64_t total_bytes = 0;
+  for (const auto &input : inputs) {
+    total_bytes += static_cast<std::uint64_t>(input.bytes);
+  }
+
+  std::uint64_t solve_ns = 0;
+  size_t prefetched = 0;
+  size_t failed = 0;
+  const BatchResult *slowest = &results.front();
+  for (const auto &result : results) {
+    std::uint64_t duration = result.end_ns - result.start_ns;
+    solve_ns += duration;
+    prefetched += result.prefetched ? 1 : 0;
+    failed += result.status == "ok" ? 0 : 1;
+    if (duration > slowest->end_ns - slowest->start_ns) {
+      slowest = &result;
+    }
+  }
+
+  std::printf("day%d: %zu inputs (%s) x %zu part%s on %zu jobs\n", options.day, inputs.size(),
+              format_bytes(static_cast<std::int64_t>(total_bytes)).c_str(), parts.size(), parts.size() == 1 ? "" : "s",
+              jobs);
+  std::printf("wall %s, sum of solve times %s", format_duration(wall_ns).c_str(), format_duration(solve_ns).c_str());
+  if (wall_ns > 0) {
+    std::printf(", %.1f inputs/s, %.1f MB/s", static_cast<double>(inputs.size()) * 1e9 / static_cast<double>(wall_ns),
+                static_cast<double>(total_bytes) * 1e3 / static_cast<double>(wall_ns));
+  }
+  std::printf("\nprefetched %zu of %zu runs, slowest %s part %d in %s\n", prefetched, results.size(),
+              slowest->input->path.c_str(), slowest->solution->part,
+              format_duration(slowest->end_ns - slowest->start_ns).c_str());
+  if (failed > 0) {
+    std::printf("%zu runs failed\n", failed);
+  }
+  context.print_busy_time(stdout, wall_ns);
+
+  bool written = true;
+  if (!options.csv_path.empty()) {
+    written = write_csv(options.csv_path, results) && written;
+  }
+  if (!options.json_path.empty()) {
+    written = write_json(options.json_path, options, wall_ns, results) && written;
+  }
+
+  return failed == 0 && written ? EXIT_SUCCESS : EXIT_FAILURE;
+}
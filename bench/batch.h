@@ -0,0 +1,28 @@
+#ifndef BATCH_H_K7QD3NVX
+#define BATCH_H_K7QD3NVX
+
+#include <cstddef>
+#include <string>
+
+struct BatchOptions {
+  /* a directory of inputs, or a manifest file listing one input per line */
+  std::string source;
+  int day = 0;
+  int part = 0;
+  size_t jobs = 1;
+  std::string csv_path;
+  std::string json_path;
+};
+
+/*
+ * Runs the parts of one day over every input of options.source with at most
+ * options.jobs inputs in flight. Jobs are tasks on the pool of the global
+ * ExecutionContext, so there are never more of them than it has threads.
+ * While a job solves one input it maps the input it will most likely take
+ * next and asks for readahead of it, so the reads overlap with solving.
+ * Prints a summary and writes one row per input and part to the CSV and
+ * JSON files that are set. Returns the exit code.
+ */
+[[nodiscard]] int run_batch(const BatchOptions &options);
+
+#endif /* end of include guard: BATCH_H_K7QD3NVX */
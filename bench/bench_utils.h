@@ -0,0 +1,73 @@
+#ifndef BENCH_UTILS_H_P8DM4ZWA
+#define BENCH_UTILS_H_P8DM4ZWA
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "json.h"
+#include "registry.h"
+
+/*
+ * Points stdout at /dev/null while alive. The solvers print their progress
+ * and answers, which would otherwise end up in the measurements.
+ */
+class SilencedStdout {
+public:
+  SilencedStdout() {
+    std::fflush(stdout);
+    std::cout.flush();
+    saved_fd = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved_fd != -1 && null_fd != -1) {
+      dup2(null_fd, STDOUT_FILENO);
+    }
+    if (null_fd != -1) {
+      close(null_fd);
+    }
+  }
+
+  SilencedStdout(const SilencedStdout &) = delete;
+  SilencedStdout &operator=(const SilencedStdout &) = delete;
+
+  ~SilencedStdout() {
+    std::fflush(stdout);
+    std::cout.flush();
+    if (saved_fd != -1) {
+      dup2(saved_fd, STDOUT_FILENO);
+      close(saved_fd);
+    }
+  }
+
+private:
+  int saved_fd = -1;
+};
+
+/* -1 when the path is missing or not a regular file */
+[[nodiscard]] inline std::int64_t file_size(const std::string &path) noexcept {
+  struct stat s;
+  if (stat(path.c_str(), &s) != 0 || !S_ISREG(s.st_mode)) {
+    return -1;
+  }
+  return s.st_size;
+}
+
+/* Nearest rank percentile of sorted, non empty samples, fraction in (0, 1] */
+[[nodiscard]] inline std::uint64_t nearest_rank(const std::vector<std::uint64_t> &sorted, double fraction) noexcept {
+  auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/* root/dayN/<input name> */
+[[nodiscard]] inline std::string input_path(const std::string &root, const Solution &solution) {
+  return root + "/day" + std::to_string(solution.day) + "/" + std::string(solution.input_name);
+}
+
+#endif /* end of include guard: BENCH_UTILS_H_P8DM4ZWA */
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "bench_utils.h"
+#include "service.h"
+#include "utils.h"
+
+/*
+ * aoc_client sends puzzle inputs to a running aoc_service and reports the
+ * answers and the latency of every request: the round trip measured here,
+ * and the solve time the service reports for each part.
+ */
+
+namespace {
+struct Options {
+  std::string socket_path;
+  int part = 0;
+  size_t repeat = 1;
+  size_t connections = 1;
+  std::vector<std::string> inputs;
+};
+
+struct Input {
+  std::string path;
+  std::string content;
+  /* body of the first reply, later replies are checked against its answers */
+  std::string answers;
+};
+
+struct Sample {
+  std::uint64_t round_trip_ns = 0;
+  std::uint64_t solve_ns = 0;
+};
+
+void usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s --socket PATH [--part N] [--repeat N] [--connections N] INPUT...\n"
+               "  Sends every INPUT --repeat times over --connections connections and\n"
+               "  prints the answers and the latency percentiles.\n",
+               name);
+}
+
+[[nodiscard]] bool parse_options(int argc, char *argv[], Options &options) {
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    if (!arg.starts_with("--")) {
+      options.inputs.emplace_back(arg);
+      continue;
+    }
+    if (idx + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++idx];
+
+    if (arg == "--socket") {
+      options.socket_path = value;
+    } else if (arg == "--part") {
+      options.part = parse_number<int>(value);
+    } else if (arg == "--repeat") {
+      options.repeat = std::max<size_t>(1, parse_number<size_t>(value));
+    } else if (arg == "--connections") {
+      options.connections = std::max<size_t>(1, parse_number<size_t>(value));
+    } else {
+      return false;
+    }
+  }
+  return !options.socket_path.empty() && !options.inputs.empty();
+}
+
+[[nodiscard]] int connect_to(const std::string &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    return -1;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+/* Answers of a reply body without the timings, "<part> <answer>" per line */
+[[nodiscard]] std::string answers_of(std::string_view body) {
+  std::string answers;
+  for (std::string_view line : LineRange{body}) {
+    answers += line.substr(0, line.rfind(' '));
+    answers += '\n';
+  }
+  return answers;
+}
+
+/* Sum of the solve times of a reply body */
+[[nodiscard]] std::uint64_t solve_ns_of(std::string_view body) {
+  std::uint64_t total = 0;
+  for (std::string_view line : LineRange{body}) {
+    total += parse_number<std::uint64_t>(line.substr(line.rfind(' ') + 1));
+  }
+  return total;
+}
+
+void print_percentiles(const char *name, std::vector<std::uint64_t> samples) {
+  std::sort(samples.begin(), samples.end());
+  std::printf("%-10s p50 %12s  p90 %12s  p99 %12s  max %12s\n", name, format_duration(nearest_rank(samples, 0.5)).c_str(),
+              format_duration(nearest_rank(samples, 0.9)).c_str(), format_duration(nearest_rank(samples, 0.99)).c_str(),
+              format_duration(samples.back()).c_str());
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  Profiler::instance().set_report_at_exit(false);
+
+  std::vector<Input> inputs;
+  for (const auto &path : options.inputs) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+      std::fprintf(stderr, "cannot read %s\n", path.c_str());
+      return EXIT_FAILURE;
+    }
+    inputs.push_back({path, std::string(std::istreambuf_iterator<char>(file), {}), {}});
+  }
+
+  size_t request_count = inputs.size() * options.repeat;
+  std::vector<Sample> samples(request_count);
+  std::atomic<size_t> next_request{0};
+  std::atomic<size_t> failed{0};
+  std::mutex answers_mutex;
+
+  /* Requests are numbered input by input, each one sent repeat times in a row */
+  auto run_connection = [&] {
+    int fd = connect_to(options.socket_path);
+    if (fd < 0) {
+      std::perror(options.socket_path.c_str());
+      failed += 1;
+      return;
+    }
+    std::string body;
+    for (size_t request = next_request++; request < request_count; request = next_request++) {
+      auto &input = inputs[request / options.repeat];
+      auto start = std::chrono::steady_clock::now();
+      service::RequestHeader header;
+      header.part = static_cast<std::uint32_t>(options.part);
+      header.payload_bytes = input.content.size();
+      service::ResponseHeader response;
+      if (!service::write_all(fd, &header, sizeof(header)) ||
+          !service::write_all(fd, input.content.data(), input.content.size()) ||
+          !service::read_exact(fd, &response, sizeof(response)) || response.magic != service::response_magic) {
+        std::fprintf(stderr, "%s: connection lost\n", input.path.c_str());
+        failed += 1;
+        break;
+      }
+      body.resize(response.body_bytes);
+      if (!service::read_exact(fd, body.data(), body.size())) {
+        failed += 1;
+        break;
+      }
+      auto round_trip = std::chrono::steady_clock::now() - start;
+
+      if (response.status != service::Status::ok) {
+        std::fprintf(stderr, "%s: %s\n", input.path.c_str(), body.c_str());
+        failed += 1;
+        continue;
+      }
+      samples[request].round_trip_ns =
+        static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(round_trip).count());
+      samples[request].solve_ns = solve_ns_of(body);
+      std::lock_guard lock(answers_mutex);
+      auto answers = answers_of(body);
+      if (input.answers.empty()) {
+        input.answers = answers;
+      } else if (input.answers != answers) {
+        std::fprintf(stderr, "%s: answers changed between requests\n", input.path.c_str());
+        failed += 1;
+      }
+    }
+    close(fd);
+  };
+
+  auto run_start = std::chrono::steady_clock::now();
+  std::vector<std::thread> connections;
+  for (size_t idx = 0; idx < std::min(options.connections, request_count); ++idx) {
+    connections.emplace_back(run_connection);
+  }
+  for (auto &connection : connections) {
+    connection.join();
+  }
+  auto wall_ns = static_cast<std::uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - run_start).count());
+
+  for (const auto &input : inputs) {
+    if (input.answers.empty()) {
+      continue;
+    }
+    std::printf("%s:", input.path.c_str());
+    for (std::string_view line : LineRange{input.answers}) {
+      std::printf(" part %.*s", static_cast<int>(line.size()), line.data());
+    }
+    std::printf("\n");
+  }
+
+  /* Failed requests have no sample */
+  std::vector<std::uint64_t> round_trips;
+  std::vector<std::uint64_t> solves;
+  for (const auto &sample : samples) {
+    if (sample.round_trip_ns != 0) {
+      round_trips.push_back(sample.round_trip_ns);
+      solves.push_back(sample.solve_ns);
+    }
+  }
+  std::printf("\n%zu requests over %zu connections in %s", round_trips.size(), connections.size(),
+              format_duration(wall_ns).c_str());
+  if (wall_ns > 0) {
+    std::printf(", %.1f requests/s", static_cast<double>(round_trips.size()) * 1e9 / static_cast<double>(wall_ns));
+  }
+  std::printf("\n");
+  if (!round_trips.empty()) {
+    print_percentiles("round trip", round_trips);
+    print_percentiles("solve", solves);
+  }
+  if (failed > 0) {
+    std::printf("%zu requests failed\n", failed.load());
+  }
+
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
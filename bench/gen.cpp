@@ -0,0 +1,710 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "utils.h"
+
+/*
+ * aoc_gen writes synthetic puzzle input for one day, in the same format as
+ * the real input, until roughly --size bytes have been written. The same
+ * seed always gives the same file.
+ */
+
+namespace {
+/* Buffers output and counts every byte written, generators stop on size() */
+class Output {
+public:
+  explicit Output(std::FILE *out) : out(out) { buffer.reserve(flush_size + 4096); }
+
+  Output(const Output &) = delete;
+  Output &operator=(const Output &) = delete;
+
+  ~Output() { (void)flush(); }
+
+  void put(std::string_view text) {
+    buffer.append(text);
+    written += text.size();
+    if (buffer.size() >= flush_size) {
+      (void)flush();
+    }
+  }
+
+  void put(char c) { put(std::string_view{&c, 1}); }
+
+  void put(std::int64_t number) {
+    std::array<char, 24> digits;
+    auto [end, ec] = std::to_chars(digits.begin(), digits.end(), number);
+    put(std::string_view{digits.data(), static_cast<size_t>(end - digits.data())});
+  }
+
+  void put(int number) { put(static_cast<std::int64_t>(number)); }
+
+  [[nodiscard]] std::uint64_t size() const noexcept { return written; }
+
+  /* false once any write has failed */
+  [[nodiscard]] bool flush() {
+    if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+      healthy = false;
+    }
+    buffer.clear();
+    return healthy;
+  }
+
+private:
+  static constexpr size_t flush_size = 1 << 20;
+
+  std::FILE *out;
+  std::string buffer;
+  std::uint64_t written = 0;
+  bool healthy = true;
+};
+
+struct Random {
+  std::mt19937_64 engine;
+
+  [[nodiscard]] std::int64_t between(std::int64_t low, std::int64_t high) {
+    return std::uniform_int_distribution<std::int64_t>{low, high}(engine);
+  }
+
+  [[nodiscard]] bool chance(double probability) { return std::bernoulli_distribution{probability}(engine); }
+
+  template <typename T>
+  [[nodiscard]] const typename T::value_type &pick(const T &values) {
+    return values[static_cast<size_t>(between(0, static_cast<std::int64_t>(values.size()) - 1))];
+  }
+
+  template <typename T>
+  void shuffle(T &values) {
+    std::shuffle(values.begin(), values.end(), engine);
+  }
+};
+
+using generator_fn_t = void (*)(Output &out, std::uint64_t target, Random &random);
+
+struct Generator {
+  int day;
+  std::string_view description;
+  generator_fn_t generate;
+};
+
+/* Calorie blocks separated by blank lines */
+void generate_day1(Output &out, std::uint64_t target, Random &random) {
+  while (out.size() < target) {
+    if (out.size() > 0) {
+      out.put('\n');
+    }
+    for (auto items = random.between(1, 14); items > 0; --items) {
+      out.put(random.between(1000, 60000));
+      out.put('\n');
+    }
+  }
+}
+
+/* Strategy guide rounds, "A X" */
+void generate_day2(Output &out, std::uint64_t target, Random &random) {
+  while (out.size() < target) {
+    out.put(static_cast<char>('A' + random.between(0, 2)));
+    out.put(' ');
+    out.put(static_cast<char>('X' + random.between(0, 2)));
+    out.put('\n');
+  }
+}
+
+/*
+ * Rucksacks in groups of three. Each line's halves share one item and the
+ * three lines share one badge, the remaining items come from pools that are
+ * disjoint between halves and lines so nothing else is shared.
+ */
+void generate_day3(Output &out, std::uint64_t target, Random &random) {
+  std::string items;
+  for (char c = 'a'; c <= 'z'; ++c) {
+    items.push_back(c);
+  }
+  for (char c = 'A'; c <= 'Z'; ++c) {
+    items.push_back(c);
+  }
+
+  constexpr size_t pool_size = 8;
+  while (out.size() < target) {
+    random.shuffle(items);
+    char badge = items[0];
+    for (size_t line = 0; line < 3; ++line) {
+      char shared = items[1 + line];
+      std::string_view left_pool{items.data() + 4 + (line * 2) * pool_size, pool_size};
+      std::string_view right_pool{items.data() + 4 + (line * 2 + 1) * pool_size, pool_size};
+
+      auto half_size = random.between(4, 16);
+      std::string left{shared};
+      std::string right{shared, badge};
+      while (static_cast<std::int64_t>(left.size()) < half_size) {
+        left.push_back(random.pick(left_pool));
+      }
+      while (static_cast<std::int64_t>(right.size()) < half_size) {
+        right.push_back(random.pick(right_pool));
+      }
+      random.shuffle(left);
+      random.shuffle(right);
+      out.put(left);
+      out.put(right);
+      out.put('\n');
+    }
+  }
+}
+
+/* Section assignment pairs, "2-4,6-8", within 1-99 */
+void generate_day4(Output &out, std::uint64_t target, Random &random) {
+  while (out.size() < target) {
+    for (int pair = 0; pair < 2; ++pair) {
+      auto start = random.between(1, 99);
+      out.put(start);
+      out.put('-');
+      out.put(random.between(start, 99));
+      out.put(pair == 0 ? ',' : '\n');
+    }
+  }
+}
+
+/* Nine crate stacks followed by moves that never take more than a stack holds */
+void generate_day5(Output &out, std::uint64_t target, Random &random) {
+  constexpr size_t stack_count = 9;
+  std::array<std::int64_t, stack_count> heights;
+  for (auto &height : heights) {
+    height = random.between(5, 20);
+  }
+
+  auto highest = *std::max_element(heights.begin(), heights.end());
+  for (auto row = highest; row > 0; --row) {
+    for (size_t stack = 0; stack < stack_count; ++stack) {
+      if (heights[stack] >= row) {
+        out.put('[');
+        out.put(static_cast<char>('A' + random.between(0, 25)));
+        out.put(']');
+      } else {
+        out.put("   ");
+      }
+      out.put(stack + 1 == stack_count ? '\n' : ' ');
+    }
+  }
+  for (size_t stack = 0; stack < stack_count; ++stack) {
+    out.put(' ');
+    out.put(static_cast<int>(stack + 1));
+    out.put(stack + 1 == stack_count ? " \n\n" : "  ");
+  }
+
+  while (out.size() < target) {
+    size_t from = 0;
+    do {
+      from = static_cast<size_t>(random.between(0, stack_count - 1));
+    } while (heights[from] == 0);
+    size_t to = static_cast<size_t>(random.between(0, stack_count - 2));
+    to += to >= from ? 1 : 0;
+    auto amount = random.between(1, heights[from]);
+    heights[from] -= amount;
+    heights[to] += amount;
+
+    out.put("move ");
+    out.put(amount);
+    out.put(" from ");
+    out.put(static_cast<int>(from + 1));
+    out.put(" to ");
+    out.put(static_cast<int>(to + 1));
+    out.put('\n');
+  }
+}
+
+/*
+ * A datastream drawn from only three letters, so neither marker can appear
+ * until the fourteen distinct letters at the very end.
+ */
+void generate_day6(Output &out, std::uint64_t target, Random &random) {
+  std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
+  random.shuffle(alphabet);
+  std::string_view filler{alphabet.data(), 3};
+
+  constexpr std::uint64_t marker_length = 14;
+  while (out.size() + marker_length + 1 < target) {
+    out.put(random.pick(filler));
+  }
+  random.shuffle(alphabet);
+  out.put(std::string_view{alphabet.data(), marker_length});
+  out.put('\n');
+}
+
+void generate_day7_directory(Output &out, std::uint64_t target, Random &random, std::int64_t &next_id, int depth) {
+  out.put("$ ls\n");
+  for (auto files = random.between(1, 5); files > 0; --files) {
+    out.put(random.between(1000, 300000));
+    out.put(" f");
+    out.put(next_id++);
+    out.put(".txt\n");
+  }
+  std::vector<std::int64_t> directories(depth < 8 && out.size() < target ? random.between(0, 3) : 0);
+  for (auto &directory : directories) {
+    directory = next_id++;
+    out.put("dir d");
+    out.put(directory);
+    out.put('\n');
+  }
+  for (auto directory : directories) {
+    out.put("$ cd d");
+    out.put(directory);
+    out.put('\n');
+    generate_day7_directory(out, target, random, next_id, depth + 1);
+    out.put("$ cd ..\n");
+  }
+}
+
+/* Terminal log walking a random tree, root is listed again for every batch */
+void generate_day7(Output &out, std::uint64_t target, Random &random) {
+  std::int64_t next_id = 0;
+  while (out.size() < target) {
+    out.put("$ cd /\n");
+    generate_day7_directory(out, target, random, next_id, 0);
+  }
+}
+
+/* Square grid of tree heights */
+void generate_day8(Output &out, std::uint64_t target, Random &random) {
+  auto side = std::max<std::int64_t>(5, static_cast<std::int64_t>(std::sqrt(static_cast<double>(target))));
+  for (std::int64_t y = 0; y < side; ++y) {
+    for (std::int64_t x = 0; x < side; ++x) {
+      out.put(static_cast<char>('0' + random.between(0, 9)));
+    }
+    out.put('\n');
+  }
+}
+
+/* Rope moves, "R 4" */
+void generate_day9(Output &out, std::uint64_t target, Random &random) {
+  constexpr std::string_view directions = "RLUD";
+  while (out.size() < target) {
+    out.put(random.pick(directions));
+    out.put(' ');
+    out.put(random.between(1, 20));
+    out.put('\n');
+  }
+}
+
+/* CPU program of noop and addx, X stays on the 40 pixel wide screen */
+void generate_day10(Output &out, std::uint64_t target, Random &random) {
+  std::int64_t x = 1;
+  while (out.size() < target) {
+    if (random.chance(0.4)) {
+      out.put("noop\n");
+    } else {
+      auto value = random.between(std::max<std::int64_t>(-20, 1 - x), std::min<std::int64_t>(20, 38 - x));
+      x += value;
+      out.put("addx ");
+      out.put(value);
+      out.put('\n');
+    }
+  }
+}
+
+/*
+ * Eight monkeys with distinct prime divisors so their product stays small,
+ * the size goes into the starting item lists.
+ */
+void generate_day11(Output &out, std::uint64_t target, Random &random) {
+  constexpr std::int64_t monkey_count = 8;
+  constexpr std::uint64_t spec_bytes = 170;
+  std::array<int, monkey_count> divisors{2, 3, 5, 7, 11, 13, 17, 19};
+  random.shuffle(divisors);
+
+  std::uint64_t item_count = std::max<std::uint64_t>(monkey_count, target > monkey_count * spec_bytes ?
+                                                                       (target - monkey_count * spec_bytes) / 4 : 0);
+  auto squaring_monkey = random.between(0, monkey_count - 1);
+
+  for (std::int64_t monkey = 0; monkey < monkey_count; ++monkey) {
+    out.put("Monkey ");
+    out.put(monkey);
+    out.put(":\n  Starting items: ");
+    auto items = item_count / monkey_count + (static_cast<std::uint64_t>(monkey) < item_count % monkey_count ? 1 : 0);
+    for (std::uint64_t item = 0; item < items; ++item) {
+      if (item > 0) {
+        out.put(", ");
+      }
+      out.put(random.between(50, 99));
+    }
+
+    out.put("\n  Operation: new = old ");
+    if (monkey == squaring_monkey) {
+      out.put("* old");
+    } else if (random.chance(0.5)) {
+      out.put("* ");
+      out.put(random.between(2, 19));
+    } else {
+      out.put("+ ");
+      out.put(random.between(1, 8));
+    }
+
+    out.put("\n  Test: divisible by ");
+    out.put(divisors[static_cast<size_t>(monkey)]);
+    std::int64_t on_true = (monkey + random.between(1, monkey_count - 1)) % monkey_count;
+    std::int64_t on_false = on_true;
+    while (on_false == on_true || on_false == monkey) {
+      on_false = random.between(0, monkey_count - 1);
+    }
+    out.put("\n    If true: throw to monkey ");
+    out.put(on_true);
+    out.put("\n    If false: throw to monkey ");
+    out.put(on_false);
+    out.put(monkey + 1 < monkey_count ? "\n\n" : "\n");
+  }
+}
+
+/*
+ * Heights ramp from a on the left to z on the right with random pits. The
+ * row holding S and E has no pits, so E can always be reached.
+ */
+void generate_day12(Output &out, std::uint64_t target, Random &random) {
+  auto width = std::max<std::int64_t>(40, static_cast<std::int64_t>(std::sqrt(static_cast<double>(target) * 4)));
+  auto height = std::max<std::int64_t>(5, static_cast<std::int64_t>(target) / (width + 1));
+  auto path_row = random.between(0, height - 1);
+
+  for (std::int64_t y = 0; y < height; ++y) {
+    for (std::int64_t x = 0; x < width; ++x) {
+      if (y == path_row && x == 0) {
+        out.put('S');
+      } else if (y == path_row && x == width - 1) {
+        out.put('E');
+      } else {
+        auto level = std::min<std::int64_t>(25, (x * 26) / width);
+        if (y != path_row && random.chance(0.3)) {
+          level = std::max<std::int64_t>(0, level - random.between(1, 3));
+        }
+        out.put(static_cast<char>('a' + level));
+      }
+    }
+    out.put('\n');
+  }
+}
+
+void generate_day13_packet(Output &out, Random &random, int depth) {
+  out.put('[');
+  for (auto elements = random.between(0, 4), idx = std::int64_t{0}; idx < elements; ++idx) {
+    if (idx > 0) {
+      out.put(',');
+    }
+    if (depth < 4 && random.chance(0.3)) {
+      generate_day13_packet(out, random, depth + 1);
+    } else {
+      out.put(random.between(0, 10));
+    }
+  }
+  out.put(']');
+}
+
+/* Packet pairs separated by blank lines */
+void generate_day13(Output &out, std::uint64_t target, Random &random) {
+  while (out.size() < target) {
+    if (out.size() > 0) {
+      out.put('\n');
+    }
+    for (int packet = 0; packet < 2; ++packet) {
+      generate_day13_packet(out, random, 0);
+      out.put('\n');
+    }
+  }
+}
+
+/* Rock paths around x=500, the scan area grows with the requested size */
+void generate_day14(Output &out, std::uint64_t target, Random &random) {
+  auto root = static_cast<std::int64_t>(std::sqrt(static_cast<double>(target)));
+  std::int64_t span = 20 + root / 8;
+  std::int64_t depth = 20 + root / 16;
+  /* Rocks right under the source would stop the sand after a few grains */
+  std::int64_t top = std::max<std::int64_t>(5, depth / 3);
+
+  while (out.size() < target) {
+    std::int64_t x = random.between(500 - span, 500 + span);
+    std::int64_t y = random.between(top, depth);
+    out.put(x);
+    out.put(',');
+    out.put(y);
+
+    bool horizontal = random.chance(0.5);
+    for (auto segments = random.between(1, 5); segments > 0; --segments, horizontal = !horizontal) {
+      auto length = random.between(1, 8) * (random.chance(0.5) ? 1 : -1);
+      if (horizontal) {
+        x = std::clamp(x + length, 500 - span, 500 + span);
+      } else {
+        y = std::clamp(y + length, top, depth);
+      }
+      out.put(" -> ");
+      out.put(x);
+      out.put(',');
+      out.put(y);
+    }
+    out.put('\n');
+  }
+}
+
+/* Sensors and their closest beacons in the 0-4000000 search square */
+void generate_day15(Output &out, std::uint64_t target, Random &random) {
+  constexpr std::int64_t limit = 4000000;
+  while (out.size() < target) {
+    auto sensor_x = random.between(0, limit);
+    auto sensor_y = random.between(0, limit);
+    out.put("Sensor at x=");
+    out.put(sensor_x);
+    out.put(", y=");
+    out.put(sensor_y);
+    out.put(": closest beacon is at x=");
+    out.put(sensor_x + random.between(-1000000, 1000000));
+    out.put(", y=");
+    out.put(sensor_y + random.between(-1000000, 1000000));
+    out.put('\n');
+  }
+}
+
+/*
+ * A sparse connected valve graph starting at AA, mostly corridors like the
+ * real input. Two letter names cap it at 676 valves. The solvers are
+ * exponential in the number of valves with a flow rate, so that grows from
+ * 7 up to the real input's 15 as the graph does.
+ */
+void generate_day16(Output &out, std::uint64_t target, Random &random) {
+  constexpr std::uint64_t max_valves = 26 * 26;
+  constexpr std::uint64_t line_bytes = 55;
+  auto valve_count = std::clamp<std::uint64_t>(target / line_bytes, 10, max_valves);
+  if (target / line_bytes > max_valves) {
+    std::fprintf(stderr, "day16 is capped at %lu valves\n", max_valves);
+  }
+
+  std::vector<std::string> names;
+  for (char first = 'A'; first <= 'Z'; ++first) {
+    for (char second = 'A'; second <= 'Z'; ++second) {
+      names.push_back(std::string{first, second});
+    }
+  }
+  random.shuffle(names);
+  std::iter_swap(names.begin(), std::find(names.begin(), names.end(), "AA"));
+  names.resize(valve_count);
+
+  std::vector<std::vector<size_t>> tunnels(valve_count);
+  auto connect = [&tunnels](size_t a, size_t b) {
+    if (a != b && std::find(tunnels[a].begin(), tunnels[a].end(), b) == tunnels[a].end()) {
+      tunnels[a].push_back(b);
+      tunnels[b].push_back(a);
+    }
+  };
+  for (size_t valve = 1; valve < valve_count; ++valve) {
+    connect(valve, static_cast<size_t>(random.between(0, static_cast<std::int64_t>(valve) - 1)));
+  }
+  for (size_t extra = 0; extra < valve_count / 10; ++extra) {
+    connect(static_cast<size_t>(random.between(0, static_cast<std::int64_t>(valve_count) - 1)),
+            static_cast<size_t>(random.between(0, static_cast<std::int64_t>(valve_count) - 1)));
+  }
+
+  std::vector<std::int64_t> flow_rates(valve_count, 0);
+  std::vector<size_t> working(valve_count - 1);
+  std::iota(working.begin(), working.end(), 1);
+  random.shuffle(working);
+  working.resize(std::min<size_t>(std::min<size_t>(15, 6 + valve_count / 64), working.size()));
+  for (auto valve : working) {
+    flow_rates[valve] = random.between(1, 25);
+  }
+
+  for (size_t valve = 0; valve < valve_count; ++valve) {
+    out.put("Valve ");
+    out.put(names[valve]);
+    out.put(" has flow rate=");
+    out.put(flow_rates[valve]);
+    out.put(tunnels[valve].size() == 1 ? "; tunnel leads to valve " : "; tunnels lead to valves ");
+    for (size_t idx = 0; idx < tunnels[valve].size(); ++idx) {
+      if (idx > 0) {
+        out.put(", ");
+      }
+      out.put(names[tunnels[valve][idx]]);
+    }
+    out.put('\n');
+  }
+}
+
+/* A single line of jets */
+void generate_day17(Output &out, std::uint64_t target, Random &random) {
+  while (out.size() + 1 < target) {
+    out.put(random.chance(0.5) ? '<' : '>');
+  }
+  out.put('\n');
+}
+
+/*
+ * Unique cubes, about a third of a cube shaped volume, written in scan order
+ * with a free layer around so the outside is connected.
+ */
+void generate_day18(Output &out, std::uint64_t target, Random &random) {
+  constexpr double density = 0.35;
+  constexpr double line_bytes = 9;
+  auto side = std::max<std::int64_t>(
+    4, static_cast<std::int64_t>(std::cbrt(static_cast<double>(target) / line_bytes / density)) + 1);
+
+  for (std::int64_t x = 1; x <= side && out.size() < target; ++x) {
+    for (std::int64_t y = 1; y <= side; ++y) {
+      for (std::int64_t z = 1; z <= side; ++z) {
+        if (random.chance(density)) {
+          out.put(x);
+          out.put(',');
+          out.put(y);
+          out.put(',');
+          out.put(z);
+          out.put('\n');
+        }
+      }
+    }
+  }
+}
+
+/* Numbers to mix, exactly one of them is zero */
+void generate_day20(Output &out, std::uint64_t target, Random &random) {
+  constexpr std::uint64_t line_bytes = 6;
+  auto zero_at = random.between(0, static_cast<std::int64_t>(std::max<std::uint64_t>(target / line_bytes, 1)) - 1);
+  bool zero_written = false;
+
+  for (std::int64_t line = 0; out.size() < target; ++line) {
+    if (line == zero_at) {
+      out.put("0\n");
+      zero_written = true;
+      continue;
+    }
+    auto value = random.between(-10000, 9999);
+    out.put(value >= 0 ? value + 1 : value);
+    out.put('\n');
+  }
+  if (!zero_written) {
+    out.put("0\n");
+  }
+}
+
+constexpr std::array generators{
+  Generator{1, "calorie blocks", generate_day1},
+  Generator{2, "strategy guide", generate_day2},
+  Generator{3, "rucksacks in groups of three", generate_day3},
+  Generator{4, "section assignment pairs", generate_day4},
+  Generator{5, "crate stacks and moves", generate_day5},
+  Generator{6, "datastream buffer", generate_day6},
+  Generator{7, "terminal log", generate_day7},
+  Generator{8, "tree grid", generate_day8},
+  Generator{9, "rope moves", generate_day9},
+  Generator{10, "cpu program", generate_day10},
+  Generator{11, "monkey specs", generate_day11},
+  Generator{12, "heightmap", generate_day12},
+  Generator{13, "packet pairs", generate_day13},
+  Generator{14, "rock paths", generate_day14},
+  Generator{15, "sensors and beacons", generate_day15},
+  Generator{16, "valve graph", generate_day16},
+  Generator{17, "jet pattern", generate_day17},
+  Generator{18, "cube list", generate_day18},
+  Generator{20, "numbers to mix", generate_day20},
+};
+
+/* Accepts a K, M or G suffix, powers of 1024 */
+[[nodiscard]] std::uint64_t parse_size(std::string_view text) {
+  std::uint64_t multiplier = 1;
+  if (!text.empty()) {
+    switch (text.back()) {
+    case 'K':
+    case 'k':
+      multiplier = 1ull << 10;
+      break;
+    case 'M':
+    case 'm':
+      multiplier = 1ull << 20;
+      break;
+    case 'G':
+    case 'g':
+      multiplier = 1ull << 30;
+      break;
+    }
+    if (multiplier > 1) {
+      text.remove_suffix(1);
+    }
+  }
+  return parse_number<std::uint64_t>(text) * multiplier;
+}
+
+void usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s DAY [--size SIZE] [--seed N] [--output FILE]\n"
+               "       %s --list\n"
+               "  SIZE takes a K, M or G suffix and defaults to 64K, output defaults to stdout.\n",
+               name, name);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (std::string_view{argv[1]} == "--list") {
+    for (const auto &generator : generators) {
+      std::printf("day%-3d %s\n", generator.day, generator.description.data());
+    }
+    return EXIT_SUCCESS;
+  }
+
+  std::string_view day_arg = argv[1];
+  if (day_arg.starts_with("day")) {
+    day_arg.remove_prefix(3);
+  }
+  int day = parse_number<int>(day_arg);
+  auto generator = std::find_if(generators.begin(), generators.end(), [day](const Generator &g) { return g.day == day; });
+  if (generator == generators.end()) {
+    std::fprintf(stderr, "No generator for day %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  std::uint64_t size = 64 << 10;
+  std::uint64_t seed = 2022;
+  const char *output_path = nullptr;
+  for (int idx = 2; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    if (idx + 1 >= argc) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    if (arg == "--size") {
+      size = parse_size(argv[++idx]);
+    } else if (arg == "--seed") {
+      seed = parse_number<std::uint64_t>(argv[++idx]);
+    } else if (arg == "--output") {
+      output_path = argv[++idx];
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::FILE *file = output_path != nullptr ? std::fopen(output_path, "w") : stdout;
+  if (file == nullptr) {
+    std::perror(output_path);
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+  {
+    Random random{std::mt19937_64{seed}};
+    Output out{file};
+    generator->generate(out, size, random);
+    ok = out.flush();
+  }
+  if (output_path != nullptr) {
+    ok = std::fclose(file) == 0 && ok;
+  }
+  if (!ok) {
+    std::perror(output_path != nullptr ? output_path : "stdout");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
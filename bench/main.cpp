@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bench_utils.h"
+#include "utils.h"
+
+#ifndef AOC_GIT_REV
+#define AOC_GIT_REV "unknown"
+#endif
+
+namespace {
+struct Options {
+  size_t warmup = 1;
+  size_t iterations = 10;
+  std::string input_root = AOC_SOURCE_DIR;
+  int day = 0;
+  int part = 0;
+  bool profile = false;
+  std::string json_path;
+};
+
+struct Stats {
+  std::uint64_t min_ns = 0;
+  std::uint64_t median_ns = 0;
+  std::uint64_t p99_ns = 0;
+  double mean_ns = 0;
+  double stddev_ns = 0;
+};
+
+[[nodiscard]] Stats compute_stats(std::vector<std::uint64_t> samples) {
+  Stats stats;
+  if (samples.empty()) {
+    return stats;
+  }
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+
+  stats.min_ns = samples.front();
+  stats.median_ns = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  stats.p99_ns = nearest_rank(samples, 0.99);
+
+  stats.mean_ns = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(n);
+  if (n > 1) {
+    double square_sum = 0;
+    for (auto sample : samples) {
+      double diff = static_cast<double>(sample) - stats.mean_ns;
+      square_sum += diff * diff;
+    }
+    stats.stddev_ns = std::sqrt(square_sum / static_cast<double>(n - 1));
+  }
+  return stats;
+}
+
+struct RunResult {
+  int day;
+  int part;
+  std::uint64_t input_bytes;
+  std::string answer;
+  std::string status;
+  std::vector<std::uint64_t> samples;
+};
+
+/* Raw samples are kept so baseline.py can run its significance test on them */
+[[nodiscard]] bool write_json(const Options &options, const std::vector<RunResult> &results) {
+  std::FILE *out = std::fopen(options.json_path.c_str(), "w");
+  if (out == nullptr) {
+    std::perror(options.json_path.c_str());
+    return false;
+  }
+
+  std::fprintf(out, "{\n  \"git_rev\": ");
+  write_json_string(out, AOC_GIT_REV);
+  std::fprintf(out, ",\n  \"warmup\": %zu,\n  \"iterations\": %zu,\n  \"results\": [", options.warmup,
+               options.iterations);
+  for (size_t idx = 0; idx < results.size(); ++idx) {
+    const auto &result = results[idx];
+    std::fprintf(out, "%s\n    {\"day\": %d, \"part\": %d, \"input_bytes\": %lu, \"answer\": ", idx == 0 ? "" : ",",
+                 result.day, result.part, result.input_bytes);
+    write_json_string(out, result.answer);
+    std::fprintf(out, ", \"status\": ");
+    write_json_string(out, result.status);
+    std::fprintf(out, ", \"samples_ns\": [");
+    for (size_t sample = 0; sample < result.samples.size(); ++sample) {
+      std::fprintf(out, "%s%lu", sample == 0 ? "" : ", ", result.samples[sample]);
+    }
+    std::fprintf(out, "]}");
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+
+  return std::fclose(out) == 0;
+}
+
+void usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s [--iterations N] [--warmup N] [--inputs DIR] [--day N] [--part N] [--profile] [--json FILE]\n"
+               "  Inputs are read from DIR/dayN/<input>, DIR defaults to the source tree.\n"
+               "  --json writes every sample for bench/baseline.py.\n",
+               name);
+}
+
+[[nodiscard]] bool parse_options(int argc, char *argv[], Options &options) {
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    auto value = [&]() -> const char * { return idx + 1 < argc ? argv[++idx] : nullptr; };
+
+    if (arg == "--profile") {
+      options.profile = true;
+      continue;
+    }
+
+    const char *v = nullptr;
+    if (arg == "--iterations" && (v = value()) != nullptr) {
+      options.iterations = std::max<size_t>(1, parse_number<size_t>(v));
+    } else if (arg == "--warmup" && (v = value()) != nullptr) {
+      options.warmup = parse_number<size_t>(v);
+    } else if (arg == "--inputs" && (v = value()) != nullptr) {
+      options.input_root = v;
+    } else if (arg == "--day" && (v = value()) != nullptr) {
+      options.day = parse_number<int>(v);
+    } else if (arg == "--part" && (v = value()) != nullptr) {
+      options.part = parse_number<int>(v);
+    } else if (arg == "--json" && (v = value()) != nullptr) {
+      options.json_path = v;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  Profiler::instance().set_report_at_exit(options.profile);
+
+  std::printf("%-6s %-5s %12s %12s %12s %12s  %-16s %s\n", "day", "part", "min", "median", "p99", "stddev", "answer",
+              "status");
+
+  bool all_ok = true;
+  std::vector<RunResult> results;
+  for (const auto &solution : SolutionRegistry::instance().solutions()) {
+    if ((options.day != 0 && solution.day != options.day) || (options.part != 0 && solution.part != options.part)) {
+      continue;
+    }
+
+    std::string day_name = "day" + std::to_string(solution.day);
+    std::string input = input_path(options.input_root, solution);
+    std::int64_t input_bytes = file_size(input);
+    if (input_bytes < 0) {
+      std::printf("%-6s %-5d %12s %12s %12s %12s  %-16s %s\n", day_name.c_str(), solution.part, "-", "-", "-", "-", "-",
+                  "no input");
+      continue;
+    }
+
+    std::string answer;
+    std::vector<std::uint64_t> samples;
+    samples.reserve(options.iterations);
+    {
+      SilencedStdout silenced;
+      for (size_t idx = 0; idx < options.warmup; ++idx) {
+        answer = solution.solve(input);
+      }
+      for (size_t idx = 0; idx < options.iterations; ++idx) {
+        auto start_time = std::chrono::steady_clock::now();
+        answer = solution.solve(input);
+        auto end_time = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+      }
+    }
+
+    std::string status = "unchecked";
+    if (!solution.expected.empty()) {
+      if (answer == solution.expected) {
+        status = "ok";
+      } else {
+        status = "MISMATCH, expected " + std::string(solution.expected);
+        all_ok = false;
+      }
+    }
+
+    Stats stats = compute_stats(samples);
+    std::printf("%-6s %-5d %12s %12s %12s %12s  %-16s %s\n", day_name.c_str(), solution.part,
+                format_duration(stats.min_ns).c_str(), format_duration(stats.median_ns).c_str(),
+                format_duration(stats.p99_ns).c_str(),
+                format_duration(static_cast<std::uint64_t>(stats.stddev_ns)).c_str(), answer.c_str(), status.c_str());
+    std::fflush(stdout);
+
+    results.push_back({solution.day, solution.part, static_cast<std::uint64_t>(input_bytes), std::move(answer),
+                       std::move(status), std::move(samples)});
+  }
+
+  if (!options.json_path.empty() && !write_json(options, results)) {
+    return EXIT_FAILURE;
+  }
+
+  return all_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
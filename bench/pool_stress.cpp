@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "utils.h"
+
+/*
+ * aoc_pool_stress runs many small parallel_for, parallel_reduce and plain
+ * submit/wait rounds on the global ExecutionContext and checks every result.
+ * It runs in deterministic mode by default, where workers only ever run
+ * their own tasks and a missed wakeup leaves a task stranded, so a round
+ * that makes no progress for --timeout seconds is reported as a hang.
+ */
+
+namespace {
+struct Options {
+  size_t rounds = 100000;
+  size_t threads = 4;
+  bool stealing = false;
+  int timeout_s = 10;
+};
+
+void usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s [--rounds N] [--threads N] [--stealing] [--timeout SECONDS]\n"
+               "  Checks --rounds small parallel loops on --threads workers (default 4),\n"
+               "  without work stealing unless --stealing, and fails if any result is\n"
+               "  wrong or a round hangs for --timeout seconds (default 10).\n",
+               name);
+}
+
+[[nodiscard]] bool parse_options(int argc, char *argv[], Options &options) {
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    if (arg == "--stealing") {
+      options.stealing = true;
+      continue;
+    }
+    if (idx + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++idx];
+
+    if (arg == "--rounds") {
+      options.rounds = parse_number<size_t>(value);
+    } else if (arg == "--threads") {
+      options.threads = std::max<size_t>(1, parse_number<size_t>(value));
+    } else if (arg == "--timeout") {
+      options.timeout_s = std::max(1, parse_number<int>(value));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* False if the round computed the wrong answer */
+[[nodiscard]] bool run_round(ExecutionContext &context, size_t round) {
+  /* Sizes from a single item up to a few chunks per worker */
+  size_t count = 1 + (round * 7919) % 300;
+  switch (round % 3) {
+  case 0: {
+    std::vector<std::uint32_t> hits(count);
+    context.parallel_for(count, [&](size_t begin, size_t end) {
+      for (size_t idx = begin; idx < end; ++idx) {
+        hits[idx] += 1;
+      }
+    });
+    return std::all_of(hits.begin(), hits.end(), [](std::uint32_t hit) { return hit == 1; });
+  }
+  case 1: {
+    auto sum = context.parallel_reduce(
+      count, std::uint64_t{0}, [](size_t idx) { return static_cast<std::uint64_t>(idx); },
+      [](std::uint64_t total, std::uint64_t value) { return total + value; });
+    return sum == count * (count - 1) / 2;
+  }
+  default: {
+    /* The aoc_all batch path: tasks straight onto the pool, then wait() */
+    std::atomic<size_t> done{0};
+    auto &pool = context.pool();
+    for (size_t idx = 0; idx < count; ++idx) {
+      pool.submit([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+    }
+    pool.wait();
+    return done == count;
+  }
+  }
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  Profiler::instance().set_report_at_exit(false);
+
+  ExecutionSettings settings = ExecutionSettings::from_env();
+  settings.threads = options.threads;
+  settings.deterministic = !options.stealing;
+  ExecutionContext::configure_global(settings);
+  auto &context = ExecutionContext::global();
+
+  std::atomic<size_t> finished{0};
+  std::thread([&finished, &options] {
+    size_t seen = 0;
+    auto last_progress = std::chrono::steady_clock::now();
+    while (true) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      size_t now = finished.load();
+      if (now != seen) {
+        seen = now;
+        last_progress = std::chrono::steady_clock::now();
+      } else if (std::chrono::steady_clock::now() - last_progress > std::chrono::seconds(options.timeout_s)) {
+        std::fprintf(stderr, "round %zu made no progress for %d s, the pool hangs\n", now, options.timeout_s);
+        std::fflush(stderr);
+        std::_Exit(EXIT_FAILURE);
+      }
+    }
+  }).detach();
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < options.rounds; ++round) {
+    if (!run_round(context, round)) {
+      std::fprintf(stderr, "round %zu computed a wrong result\n", round);
+      return EXIT_FAILURE;
+    }
+    finished.store(round + 1);
+  }
+  auto wall_ns = static_cast<std::uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+  std::printf("%zu rounds on %zu %s workers in %s\n", options.rounds, context.threads(),
+              options.stealing ? "stealing" : "deterministic", format_duration(wall_ns).c_str());
+  return EXIT_SUCCESS;
+}
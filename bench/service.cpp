@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "bench_utils.h"
+#include "service.h"
+#include "utils.h"
+
+/*
+ * aoc_service keeps one day's solvers loaded and answers puzzle inputs sent
+ * over a Unix socket, see service.h for the wire format. Each input is
+ * written to an in-memory file and the registered part is handed its
+ * /proc/self/fd path, so the solvers read it exactly as they read input.txt.
+ * Heap, static tables, the ExecutionContext pool and the connection threads
+ * all outlive a request, so only the first one pays for warming them up.
+ *
+ * SIGINT or SIGTERM stops it: requests in flight are answered, every client
+ * is disconnected, and the server side latency of every request served is
+ * printed.
+ */
+
+namespace {
+struct Options {
+  std::string socket_path;
+  int day = 0;
+  int part = 0;
+  size_t connections = 4;
+};
+
+void usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s --socket PATH --day N [--part N] [--connections N]\n"
+               "  Serves day N on the Unix socket PATH until SIGINT or SIGTERM, with\n"
+               "  up to --connections clients (default 4) served at the same time.\n",
+               name);
+}
+
+[[nodiscard]] bool parse_options(int argc, char *argv[], Options &options) {
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string_view arg = argv[idx];
+    if (idx + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++idx];
+
+    if (arg == "--socket") {
+      options.socket_path = value;
+    } else if (arg == "--day") {
+      options.day = parse_number<int>(value);
+    } else if (arg == "--part") {
+      options.part = parse_number<int>(value);
+    } else if (arg == "--connections") {
+      options.connections = std::max<size_t>(1, parse_number<size_t>(value));
+    } else {
+      return false;
+    }
+  }
+  return !options.socket_path.empty() && options.day != 0;
+}
+
+/* Anonymous in-memory file the solvers read a request's input from */
+class InputFile {
+public:
+  InputFile() : fd(memfd_create("aoc_input", MFD_CLOEXEC)) {}
+
+  InputFile(const InputFile &) = delete;
+  InputFile &operator=(const InputFile &) = delete;
+
+  ~InputFile() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  [[nodiscard]] bool is_valid() const noexcept { return fd >= 0; }
+
+  [[nodiscard]] std::string path() const { return "/proc/self/fd/" + std::to_string(fd); }
+
+  [[nodiscard]] bool assign(std::string_view content) noexcept {
+    if (ftruncate(fd, 0) != 0) {
+      return false;
+    }
+    for (size_t written = 0; written < content.size();) {
+      ssize_t count = pwrite(fd, content.data() + written, content.size() - written, static_cast<off_t>(written));
+      if (count <= 0) {
+        return false;
+      }
+      written += static_cast<size_t>(count);
+    }
+    return true;
+  }
+
+private:
+  int fd;
+};
+
+class Server {
+public:
+  Server(std::vector<const Solution *> parts) : parts(std::move(parts)) {}
+
+  /* Answers requests on client until it hangs up, breaks the protocol or stop() is called */
+  void serve(int client) {
+    if (!track(client)) {
+      close(client);
+      return;
+    }
+    InputFile input;
+    std::string payload;
+    std::string body;
+    service::RequestHeader request;
+    while (service::read_exact(client, &request, sizeof(request))) {
+      if (request.magic != service::request_magic || request.payload_bytes > service::max_payload) {
+        break;
+      }
+      payload.resize(request.payload_bytes);
+      if (!service::read_exact(client, payload.data(), payload.size())) {
+        break;
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      service::ResponseHeader response;
+      body.clear();
+      if (!input.is_valid() || !input.assign(payload)) {
+        response.status = service::Status::error;
+        body = std::string("cannot stage input: ") + std::strerror(errno);
+      } else {
+        response.status = solve(input.path(), static_cast<int>(request.part), body);
+      }
+      record(start);
+
+      response.body_bytes = body.size();
+      if (!service::write_all(client, &response, sizeof(response)) ||
+          !service::write_all(client, body.data(), body.size())) {
+        break;
+      }
+    }
+    untrack(client);
+    close(client);
+  }
+
+  /*
+   * Shuts down every client socket being served, which ends their serve()
+   * once the request in flight, if any, has been answered. Clients that
+   * connect afterwards are closed straight away.
+   */
+  void stop() {
+    std::lock_guard lock(clients_mutex);
+    stopping = true;
+    for (int client : clients) {
+      shutdown(client, SHUT_RDWR);
+    }
+  }
+
+  void print_latency(std::FILE *out) {
+    std::lock_guard lock(latency_mutex);
+    std::sort(latency_ns.begin(), latency_ns.end());
+    std::fprintf(out, "%zu requests", latency_ns.size());
+    if (!latency_ns.empty()) {
+      std::fprintf(out, ", latency p50 %s p90 %s p99 %s max %s", format_duration(nearest_rank(latency_ns, 0.5)).c_str(),
+                   format_duration(nearest_rank(latency_ns, 0.9)).c_str(),
+                   format_duration(nearest_rank(latency_ns, 0.99)).c_str(),
+                   format_duration(latency_ns.back()).c_str());
+    }
+    std::fprintf(out, "\n");
+  }
+
+private:
+  [[nodiscard]] service::Status solve(const std::string &path, int part, std::string &body) const {
+    bool any = false;
+    for (const auto *solution : parts) {
+      if (part != 0 && solution->part != part) {
+        continue;
+      }
+      any = true;
+      auto start = std::chrono::steady_clock::now();
+      std::string answer;
+      try {
+        answer = solution->solve(path);
+      } catch (const std::exception &error) {
+        body = std::string("part ") + std::to_string(solution->part) + ": " + error.what();
+        return service::Status::error;
+      }
+      auto solve_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+      body += std::to_string(solution->part) + " " + answer + " " + std::to_string(solve_ns.count()) + "\n";
+    }
+    if (!any) {
+      body = "no part " + std::to_string(part) + " is served";
+      return service::Status::error;
+    }
+    return service::Status::ok;
+  }
+
+  [[nodiscard]] bool track(int client) {
+    std::lock_guard lock(clients_mutex);
+    if (stopping) {
+      return false;
+    }
+    clients.push_back(client);
+    return true;
+  }
+
+  void untrack(int client) {
+    std::lock_guard lock(clients_mutex);
+    clients.erase(std::find(clients.begin(), clients.end(), client));
+  }
+
+  void record(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    std::lock_guard lock(latency_mutex);
+    latency_ns.push_back(static_cast<std::uint64_t>(elapsed.count()));
+  }
+
+  std::vector<const Solution *> parts;
+  std::mutex clients_mutex;
+  std::vector<int> clients;
+  bool stopping = false;
+  std::mutex latency_mutex;
+  std::vector<std::uint64_t> latency_ns;
+};
+
+[[nodiscard]] int listen_on(const std::string &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::fprintf(stderr, "socket path %s is too long\n", path.c_str());
+    return -1;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    std::perror("socket");
+    return -1;
+  }
+  /* A socket file left behind by a previous run would make bind() fail */
+  unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || listen(fd, 64) != 0) {
+    std::perror(path.c_str());
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  Profiler::instance().set_report_at_exit(false);
+
+  std::vector<const Solution *> parts;
+  for (const auto &solution : SolutionRegistry::instance().solutions()) {
+    if (solution.day == options.day && (options.part == 0 || solution.part == options.part)) {
+      parts.push_back(&solution);
+    }
+  }
+  if (parts.empty()) {
+    std::fprintf(stderr, "no registered parts for day%d\n", options.day);
+    return EXIT_FAILURE;
+  }
+
+  /* Blocked before any thread starts so only sigwait() below sees them */
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+  int listen_fd = listen_on(options.socket_path);
+  if (listen_fd < 0) {
+    return EXIT_FAILURE;
+  }
+
+  Server server{parts};
+  {
+    SilencedStdout silenced;
+    /* Started up front so the first request does not pay for it */
+    [[maybe_unused]] auto &pool = ExecutionContext::global().pool();
+    std::vector<std::thread> connection_threads;
+    for (size_t idx = 0; idx < options.connections; ++idx) {
+      connection_threads.emplace_back([&server, listen_fd] {
+        while (true) {
+          int client = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+          if (client >= 0) {
+            server.serve(client);
+          } else if (errno != EINTR && errno != ECONNABORTED) {
+            return;
+          }
+        }
+      });
+    }
+    std::fprintf(stderr, "serving day%d on %s\n", options.day, options.socket_path.c_str());
+
+    int signal = 0;
+    sigwait(&stop_signals, &signal);
+    /* Wakes the threads blocked in accept(), then the ones waiting on a client */
+    shutdown(listen_fd, SHUT_RDWR);
+    server.stop();
+    for (auto &thread : connection_threads) {
+      thread.join();
+    }
+    close(listen_fd);
+    unlink(options.socket_path.c_str());
+  }
+
+  server.print_latency(stderr);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+#ifndef SERVICE_H_V9CN4TRB
+#define SERVICE_H_V9CN4TRB
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/*
+ * Wire format between aoc_service and aoc_client over a Unix stream socket.
+ * Both ends are on the same machine, so headers go out in host byte order.
+ *
+ * A request is a RequestHeader followed by the puzzle input. The reply is a
+ * ResponseHeader followed by a text body: on success one line per part
+ * solved, "<part> <answer> <solve ns>", otherwise an error message. A
+ * connection carries any number of requests, one at a time.
+ */
+namespace service {
+constexpr std::uint32_t request_magic = 0x51434f41;  /* "AOCQ" */
+constexpr std::uint32_t response_magic = 0x52434f41; /* "AOCR" */
+/* Larger payloads are refused and the connection closed */
+constexpr std::uint64_t max_payload = std::uint64_t{1} << 30;
+
+struct RequestHeader {
+  std::uint32_t magic = request_magic;
+  /* 0 for every part of the served day */
+  std::uint32_t part = 0;
+  std::uint64_t payload_bytes = 0;
+};
+
+enum class Status : std::uint32_t {
+  ok = 0,
+  error = 1,
+};
+
+struct ResponseHeader {
+  std::uint32_t magic = response_magic;
+  Status status = Status::ok;
+  std::uint64_t body_bytes = 0;
+};
+
+/* False once the peer has closed or on any error other than an interrupt */
+[[nodiscard]] inline bool read_exact(int fd, void *buffer, size_t bytes) noexcept {
+  auto *next = static_cast<char *>(buffer);
+  while (bytes > 0) {
+    ssize_t got = read(fd, next, bytes);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      return false;
+    }
+    next += got;
+    bytes -= static_cast<size_t>(got);
+  }
+  return true;
+}
+
+[[nodiscard]] inline bool write_all(int fd, const void *buffer, size_t bytes) noexcept {
+  const auto *next = static_cast<const char *>(buffer);
+  while (bytes > 0) {
+    /* send() rather than write() so a vanished peer is an error, not SIGPIPE */
+    ssize_t sent = send(fd, next, bytes, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    next += sent;
+    bytes -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+} // namespace service
+
+#endif /* end of include guard: SERVICE_H_V9CN4TRB */
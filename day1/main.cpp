@@ -1,50 +1,391 @@
 #include <vector>
-#include <fstream>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <numeric>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include "utils.h"
 
-using Elf = std::vector<int>;
+namespace day1 {
+using Elf = int;
 using ElfCrew = std::vector<Elf>;
 
-std::istream& operator>>(std::istream& is, Elf& elf) {
-  std::string number;
-  while ( std::getline(is, number, '\n') ) {
-    elf.emplace_back(std::stoi(number));
-    if (is.peek() == '\n') {
-      is.get();
-      return is;
+/* One elf's pack: the calories it carries, how many items and the heaviest one */
+struct Block {
+  Elf sum = 0;
+  int count = 0;
+  int max = 0;
+
+  void add(int calories) noexcept {
+    sum += calories;
+    count += 1;
+    max = std::max(max, calories);
+  }
+
+  /* Puts back together a pack cut in two by a chunk boundary */
+  void join(const Block &other) noexcept {
+    sum += other.sum;
+    count += other.count;
+    max = std::max(max, other.max);
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return count == 0; }
+};
+
+/*
+ * The k largest totals pushed so far, kept as a min-heap so the smallest of
+ * them is the one to drop when a larger total comes along. Holds at most k
+ * totals however many are pushed.
+ */
+class TopElves {
+public:
+  explicit TopElves(size_t k) : k(k) { heap.reserve(k); }
+
+  void push(Elf total) {
+    if (heap.size() < k) {
+      heap.push_back(total);
+      std::push_heap(heap.begin(), heap.end(), std::greater<Elf>());
+    } else if (k > 0 && total > heap.front()) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<Elf>());
+      heap.back() = total;
+      std::push_heap(heap.begin(), heap.end(), std::greater<Elf>());
+    }
+  }
+
+  void push(const Block &block) { push(block.sum); }
+
+  void merge(const TopElves &other) {
+    for (Elf total : other.heap) {
+      push(total);
+    }
+  }
+
+  /* Largest first */
+  [[nodiscard]] ElfCrew sorted() const {
+    ElfCrew elves = heap;
+    std::sort(elves.begin(), elves.end(), std::greater<Elf>());
+    return elves;
+  }
+
+private:
+  size_t k;
+  ElfCrew heap;
+};
+
+/*
+ * Every pack of the file as columns, the row being the block id. Built in
+ * one pass like the top-K totals, so any number of queries can run on it
+ * without parsing the input again.
+ */
+struct BlockTable {
+  std::vector<Elf> sum;
+  std::vector<int> count;
+  std::vector<int> max;
+
+  [[nodiscard]] size_t size() const noexcept { return sum.size(); }
+
+  void push(const Block &block) {
+    sum.push_back(block.sum);
+    count.push_back(block.count);
+    max.push_back(block.max);
+  }
+
+  void merge(const BlockTable &other) {
+    sum.insert(sum.end(), other.sum.begin(), other.sum.end());
+    count.insert(count.end(), other.count.begin(), other.count.end());
+    max.insert(max.end(), other.max.begin(), other.max.end());
+  }
+};
+
+/*
+ * What a run of whole lines says about the packs in it. Packs cut off by
+ * either end of the run are left for the neighbouring runs to finish: head
+ * is the part before the first blank line and tail the part after the last
+ * one. Every pack in between is pushed straight into blocks, a TopElves or
+ * a BlockTable.
+ */
+template <typename Sink>
+struct BlockChunk {
+  Block head;
+  bool has_blank = false;
+  Block tail;
+  Sink blocks;
+
+  BlockChunk(std::string_view lines, Sink sink) : blocks(std::move(sink)) {
+    Block block;
+    for (std::string_view line : LineRange{lines}) {
+      if (!line.empty()) {
+        block.add(parse_number<int>(line));
+        continue;
+      }
+      if (!has_blank) {
+        head = block;
+        has_blank = true;
+      } else if (!block.empty()) {
+        blocks.push(block);
+      }
+      block = {};
     }
+    (has_blank ? tail : head) = block;
   }
-  return is;
+};
+
+/* Chunks in file order, the pack cut in two between neighbours is finished here */
+template <typename Sink>
+class BlockStitcher {
+public:
+  explicit BlockStitcher(Sink sink) : blocks(std::move(sink)) {}
+
+  void add(const BlockChunk<Sink> &chunk) {
+    block.join(chunk.head);
+    if (!chunk.has_blank) {
+      return;
+    }
+    if (!block.empty()) {
+      blocks.push(block);
+    }
+    blocks.merge(chunk.blocks);
+    block = chunk.tail;
+  }
+
+  [[nodiscard]] Sink finish() {
+    if (!block.empty()) {
+      blocks.push(block);
+      block = {};
+    }
+    return std::move(blocks);
+  }
+
+private:
+  Sink blocks;
+  Block block;
+};
+
+/* Runs smaller than this are not worth handing to another thread */
+constexpr size_t min_chunk_size = 1024 * 1024;
+
+/*
+ * Every pack of the file pushed into a copy of empty, in file order, in one
+ * pass. Each window is cut at newlines into a chunk per thread of the global
+ * ExecutionContext and the chunks are parsed in parallel, then stitched
+ * together in order.
+ */
+template <typename Sink>
+[[nodiscard]] Sink scan_blocks(const FileStreamer &fs, const Sink &empty) {
+  auto &context = ExecutionContext::global();
+  BlockStitcher<Sink> stitcher{empty};
+  std::vector<BlockChunk<Sink>> chunks;
+
+  fs.for_each_line_run([&](std::string_view run) {
+    auto pieces = split_lines(run, context.threads(), min_chunk_size);
+    chunks.assign(pieces.size(), BlockChunk<Sink>{{}, empty});
+    context.parallel_for(pieces.size(), [&](size_t begin, size_t end) {
+      for (size_t idx = begin; idx < end; ++idx) {
+        chunks[idx] = BlockChunk<Sink>{pieces[idx], empty};
+      }
+    });
+    for (const auto &chunk : chunks) {
+      stitcher.add(chunk);
+    }
+  });
+
+  return stitcher.finish();
 }
 
-int main(int argc, char* argv[])
+/* Calorie totals of the k best stocked elves, largest first */
+[[nodiscard]] ElfCrew read_crew(const FileStreamer &fs, size_t k) {
+  return scan_blocks(fs, TopElves{k}).sorted();
+}
+
+[[nodiscard]] BlockTable read_blocks(const FileStreamer &fs) {
+  return scan_blocks(fs, BlockTable{});
+}
+
+/*
+ * Binary sidecar of a BlockTable: a SidecarHeader, then the sum, count and
+ * max columns one after the other in host byte order. The header records
+ * the size and modification time of the input it was built from, so a
+ * sidecar that no longer matches its input is rebuilt rather than trusted.
+ */
+constexpr std::uint32_t sidecar_magic = 0x42434f41; /* "AOCB" */
+
+struct SidecarHeader {
+  std::uint32_t magic = sidecar_magic;
+  std::uint32_t version = 1;
+  std::uint64_t source_bytes = 0;
+  std::int64_t source_mtime_ns = 0;
+  std::uint64_t rows = 0;
+};
+
+[[nodiscard]] SidecarHeader sidecar_header(const FileStreamer &source, size_t rows) noexcept {
+  SidecarHeader header;
+  header.source_bytes = static_cast<std::uint64_t>(source.s.st_size);
+  header.source_mtime_ns = static_cast<std::int64_t>(source.s.st_mtim.tv_sec) * 1'000'000'000 + source.s.st_mtim.tv_nsec;
+  header.rows = rows;
+  return header;
+}
+
+[[nodiscard]] bool save_blocks(const std::string &path, const BlockTable &table, const FileStreamer &source) {
+  std::FILE *out = std::fopen(path.c_str(), "wb");
+  if (out == nullptr) {
+    std::perror(path.c_str());
+    return false;
+  }
+  auto header = sidecar_header(source, table.size());
+  auto put = [out](const auto &column) {
+    return std::fwrite(column.data(), sizeof(column[0]), column.size(), out) == column.size();
+  };
+  bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 && put(table.sum) && put(table.count) && put(table.max);
+  ok = std::fclose(out) == 0 && ok;
+  if (!ok) {
+    std::fprintf(stderr, "%s: could not write sidecar\n", path.c_str());
+  }
+  return ok;
+}
+
+/* The table saved at path, if there is one built from source */
+[[nodiscard]] std::optional<BlockTable> load_blocks(const std::string &path, const FileStreamer &source) {
+  std::FILE *in = std::fopen(path.c_str(), "rb");
+  if (in == nullptr) {
+    return std::nullopt;
+  }
+  auto expected = sidecar_header(source, 0);
+  SidecarHeader header;
+  std::optional<BlockTable> table;
+  /* Every pack takes at least two bytes of input, a larger row count is a corrupt header */
+  if (std::fread(&header, sizeof(header), 1, in) == 1 && header.magic == expected.magic &&
+      header.version == expected.version && header.source_bytes == expected.source_bytes &&
+      header.source_mtime_ns == expected.source_mtime_ns && header.rows <= header.source_bytes / 2) {
+    BlockTable loaded;
+    loaded.sum.resize(header.rows);
+    loaded.count.resize(header.rows);
+    loaded.max.resize(header.rows);
+    auto get = [in](auto &column) {
+      return std::fread(column.data(), sizeof(column[0]), column.size(), in) == column.size();
+    };
+    if (get(loaded.sum) && get(loaded.count) && get(loaded.max)) {
+      table = std::move(loaded);
+    }
+  }
+  std::fclose(in);
+  return table;
+}
+
+/* Nearest rank percentile of sorted, non empty totals, fraction in (0, 1] */
+[[nodiscard]] Elf percentile(const ElfCrew &sorted, double fraction) noexcept {
+  auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/* Count, min, max and percentiles of the pack totals, and a histogram of them over bins equal width bins */
+void print_stats(const BlockTable &table, size_t bins) {
+  std::printf("blocks: %zu\n", table.size());
+  if (table.size() == 0) {
+    return;
+  }
+
+  long long items = std::accumulate(table.count.begin(), table.count.end(), 0LL);
+  std::printf("items: %lld, %.1f per block, heaviest %d\n", items,
+              static_cast<double>(items) / static_cast<double>(table.size()),
+              *std::max_element(table.max.begin(), table.max.end()));
+
+  ElfCrew sorted = table.sum;
+  std::sort(sorted.begin(), sorted.end());
+  std::printf("sum: min %d max %d p50 %d p99 %d\n", sorted.front(), sorted.back(), percentile(sorted, 0.5),
+              percentile(sorted, 0.99));
+
+  long long low = sorted.front();
+  long long width = (sorted.back() - low) / static_cast<long long>(bins) + 1;
+  std::vector<size_t> histogram(bins);
+  for (Elf total : sorted) {
+    histogram[static_cast<size_t>((total - low) / width)] += 1;
+  }
+  size_t tallest = *std::max_element(histogram.begin(), histogram.end());
+  for (size_t bin = 0; bin < bins; ++bin) {
+    long long first = low + width * static_cast<long long>(bin);
+    std::printf("%10lld - %-10lld %10zu %s\n", first, first + width - 1, histogram[bin],
+                std::string(histogram[bin] * 40 / tallest, '#').c_str());
+  }
+}
+
+[[nodiscard]] int part1(const ElfCrew &elves) noexcept {
+  return elves.empty() ? 0 : elves.front();
+}
+
+[[nodiscard]] int part2(const ElfCrew &elves) noexcept {
+  return std::accumulate(elves.begin(), std::next(elves.begin(), std::min<size_t>(3, elves.size())), 0);
+}
+
+const RegisterSolution register_part1{{1, 1, "elves.dat", "", [](const std::string &input) -> std::string {
+  return std::to_string(part1(read_crew(FileStreamer{input}, 1)));
+}}};
+
+const RegisterSolution register_part2{{1, 2, "elves.dat", "", [](const std::string &input) -> std::string {
+  return std::to_string(part2(read_crew(FileStreamer{input}, 3)));
+}}};
+} // namespace day1
+
+#ifndef AOC_NO_MAIN
+using namespace day1;
+
+/*
+ * Prints the statistics of every pack. With a sidecar path the table is read
+ * from there when it was built from this input, and saved there otherwise.
+ */
+int print_block_stats(const FileStreamer &fs, size_t bins, const std::string &sidecar)
 {
-  std::ifstream fs("elves.dat", fs.in);
+  std::optional<BlockTable> table;
+  if (!sidecar.empty()) {
+    table = load_blocks(sidecar, fs);
+  }
+  if (!table) {
+    table = read_blocks(fs);
+    if (!sidecar.empty() && !save_blocks(sidecar, *table, fs)) {
+      return EXIT_FAILURE;
+    }
+  }
+  print_stats(*table, bins);
+  return 0;
+}
 
-  ElfCrew elves;
-  Elf temp_elf;
+/*
+ * day1 [K] also prints the total of the K best stocked elves.
+ * day1 stats [BINS] [SIDECAR] prints statistics of the packs instead, with
+ * a histogram of BINS bins (default 10).
+ */
+int main(int argc, char* argv[])
+{
+  FileStreamer fs{"elves.dat"};
+  if (!fs.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
-  while (fs >> temp_elf) {
-      elves.push_back(temp_elf);
-      temp_elf.clear();
+  if (argc > 1 && std::string_view{argv[1]} == "stats") {
+    size_t bins = argc > 2 ? std::max<size_t>(1, parse_number<size_t>(argv[2])) : 10;
+    return print_block_stats(fs, bins, argc > 3 ? argv[3] : "");
   }
 
-  std::sort(elves.begin(), elves.end(), [](auto& elf1, auto& elf2) {
-    return std::accumulate(elf1.begin(), elf1.end(), 0) > std::accumulate(elf2.begin(), elf2.end(), 0);
-  });
+  size_t k = argc > 1 ? parse_number<size_t>(argv[1]) : 3;
+
+  ElfCrew elves = read_crew(fs, std::max<size_t>(k, 3));
 
-  int top_alfa_elf = std::accumulate(std::begin(*elves.begin()), std::end(*elves.begin()), 0);
+  int top_alfa_elf = part1(elves);
   std::cout << "Alfa elf numero uno: " << top_alfa_elf << "\n";
 
-  int total = 0;
-  for (auto elf_it = elves.begin(); elf_it != std::next(elves.begin(), 3); elf_it++) {
-    total = std::accumulate(elf_it->begin(), elf_it->end(), total);
-  }
+  int total = part2(elves);
 
   std::cout << "Top 3: " << total << "\n";
 
+  if (k != 3) {
+    long long top_k = std::accumulate(elves.begin(), std::next(elves.begin(), std::min(k, elves.size())), 0LL);
+    std::cout << "Top " << k << ": " << top_k << "\n";
+  }
+
   return 0;
 }
+#endif
@@ -2,43 +2,16 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <iostream>
-#include <sstream>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#include <unordered_map>
-#include <vector>
+#include <string_view>
+#include <string>
+#include "utils.h"
+
+namespace day10 {
 
 using value_t = std::int32_t;
 using print_func_t = size_t(size_t, std::int32_t);
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-};
-
 struct Instruction {
   enum class Op : std::uint8_t {
    noop,
@@ -46,36 +19,9 @@ struct Instruction {
   };
   Op op;
   value_t value;
-  std::unordered_map<std::string, Op> op_map{{"addx", Op::addx}, {"noop", Op::noop}};
-  [[nodiscard]] Instruction(std::string o, std::int32_t val) noexcept {
-    op = op_map[o];
-    value = val;
-  }
-
-  [[nodiscard]]
-  static std::vector<Instruction> parse_instructions(std::istream& iss) {
-    std::vector<Instruction> op_list;
-
-    while (!iss.eof()) {
-      std::string op;
-      value_t value = 0;
-      iss >> op;
-
-      if (iss.peek() != 10) {
-        iss >> value;
-      }
-
-      op_list.emplace_back(op, value);
-
-      iss.get();
-
-      if (iss.peek() == -1) {
-        break;
-      }
-
-    }
-
-    return op_list;
+  [[nodiscard]] Instruction(std::string_view line) noexcept {
+    op = line.starts_with("addx") ? Op::addx : Op::noop;
+    value = (op == Op::addx) ? parse_number<value_t>(line.substr(5)) : 0;
   }
 };
 
@@ -97,17 +43,18 @@ struct Instruction {
   return 0;
 }
 
-[[nodiscard]] size_t solver(const FileHelper &file_helper, print_func_t print_func) noexcept {
-  auto iss = file_helper.get_stringstream();
-  auto ops = Instruction::parse_instructions(iss);
-
+[[nodiscard]] size_t solver(const FileStreamer &fs, print_func_t print_func) noexcept {
   std::int32_t x = 1;
   size_t pc = 1;
   size_t result = 0;
 
-  for (std::uint32_t c = 0; c <= ops.size(); ++c) {
+  fs.for_each_line([&](std::string_view line) {
+    if (line.empty()) {
+      return;
+    }
+    Instruction instruction{line};
     result += print_func(pc, x);
-    switch (ops[c].op) {
+    switch (instruction.op) {
       case Instruction::Op::noop:
         ++pc;
         break;
@@ -115,38 +62,58 @@ struct Instruction {
         ++pc;
         result += print_func(pc, x);
         ++pc;
-        x += ops[c].value;
+        x += instruction.value;
         break;
     }
-  }
+  });
   result += print_func(pc, x);
 
   return result;
 }
 
 
-[[nodiscard]] size_t part1(const FileHelper &file_helper) noexcept {
-  size_t result = solver(file_helper, print_out_signal_strength);
+[[nodiscard]] size_t part1(const FileStreamer &fs) noexcept {
+  auto _ = TimeIt("Part1");
+  size_t result = solver(fs, print_out_signal_strength);
 
   return result;
 }
 
-[[nodiscard]] size_t part2(const FileHelper &file_helper) noexcept {
-  size_t result = solver(file_helper, print_out_display);
+[[nodiscard]] size_t part2(const FileStreamer &fs) noexcept {
+  auto _ = TimeIt("Part2");
+  size_t result = solver(fs, print_out_display);
 
   return result;
 }
 
+const RegisterSolution register_part1{{10, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileStreamer fs{input};
+  return std::to_string(part1(fs));
+}}};
+
+const RegisterSolution register_part2{{10, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileStreamer fs{input};
+  return std::to_string(part2(fs));
+}}};
+} // namespace day10
+
+#ifndef AOC_NO_MAIN
+using namespace day10;
+
 int main(void) noexcept {
   {
-  FileHelper file_helper{"input.txt"};
+  FileStreamer fs{"input.txt"};
+  if (!fs.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
-  auto result = part1(file_helper);
+  auto result = part1(fs);
   std::printf("Part1: %lu\n", result);
 
-  auto result2 = part2(file_helper);
+  auto result2 = part2(fs);
   std::printf("Part2: %lu\n", result2);
   }
 
   return EXIT_SUCCESS;
 }
+#endif
@@ -1,62 +1,23 @@
 #include <algorithm>
-#include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/regex.hpp>
-#include <boost/regex/v5/error_type.hpp>
-#include <boost/regex/v5/match_flags.hpp>
-#include <boost/regex/v5/regex_match.hpp>
-#include <boost/type_traits/is_same.hpp>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <numeric>
-#include <regex>
 #include <sstream>
 #include <string>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
 #include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
+#include "utils.h"
 
+namespace day11 {
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-
-  [[nodiscard]] std::string get_string() const noexcept {
-    return std::string(input_data, s.st_size);
-  }
-};
 
 
 struct Monkey;
@@ -64,14 +25,14 @@ struct Monkey;
 using num_t = std::uint64_t;
 using monkey_id_t = std::string;
 using monkey_group_t = std::map<std::string, Monkey>;
-num_t factor = 1;
 
-const boost::regex monkey_regex("Monkey (?<monkey_id>\\d+):\r?\n?" \
-    "\\s+Starting items: (?<starting_items>(?:\\d+,? ?)+)\r?\n?" \
-    "\\s+Operation: new = (?<first_op_statement>old|\\d+) (?<op_modifier>.) (?<second_op_statement>old|\\d+)\r?\n?" \
-    "\\s+Test: divisible by (?<test_div_by>\\d+)\r?\n?" \
-    "\\s+If true: throw to monkey (?<test_if_true>\\d+)\r?\n?" \
-    "\\s+If false: throw to monkey (?<test_if_false>\\d+)\r?\n?");
+/* Captures monkey id, starting items, operation lhs, operator, rhs, divisor and both targets */
+constexpr Pattern<"Monkey {i}:\n"
+                  " Starting items: {l}\n"
+                  " Operation: new = {w} {c} {w}\n"
+                  " Test: divisible by {i}\n"
+                  " If true: throw to monkey {i}\n"
+                  " If false: throw to monkey {i}"> monkey_pattern;
 
 struct MonkeyOp {
   enum class Op {
@@ -106,7 +67,7 @@ struct MonkeyOp {
     if (t.starts_with("old")) {
       target = true;
     } else {
-      target = static_cast<num_t>(std::stoi(t));
+      target = parse_number<num_t>(t);
     }
   }
 
@@ -136,17 +97,9 @@ struct Monkey {
   [[nodiscard]] Monkey(const Monkey&) = default;
   [[nodiscard]] Monkey(std::string monkey_nr, std::string start_items, MonkeyOp op, std::string test_div, std::string target_if_true, std::string target_if_false) noexcept : monkey_id(monkey_nr), test_target_if_true(target_if_true), test_target_if_false(target_if_false), calc_op(op) {
 
-    std::string starting_items = start_items;
-    std::vector<std::string> split_values;
-    boost::split(split_values, start_items, boost::is_any_of(","));
-
-    std::transform(split_values.cbegin(), split_values.cend(), std::back_inserter(items), [](const std::string &v) -> num_t{
-      std::string temp_level = v;
-      boost::trim(temp_level);
-      return static_cast<num_t>(std::stoi(temp_level));
-    });
+    append_integers<num_t>(start_items, items);
 
-    test_div_by = static_cast<num_t>(std::stoi(test_div));
+    test_div_by = parse_number<num_t>(test_div);
   }
   void add_parent(std::shared_ptr<monkey_group_t> parent) {
     parent_group = parent;
@@ -179,7 +132,8 @@ struct Monkey {
     items.clear();
   }
 
-  void inspect2() {
+  /* factor is the product of every monkey's divisor, worry levels are kept modulo it */
+  void inspect2(num_t factor) {
     if (items.size() == 0) {
       return;
     }
@@ -200,19 +154,16 @@ struct Monkey {
 
   [[nodiscard]]
   static std::shared_ptr<monkey_group_t> build_group(const FileHelper& file_helper) {
+    auto _ = TimeIt("build_group");
 
   std::shared_ptr<monkey_group_t> monkies = std::make_shared<monkey_group_t>();
-  auto monkey_input = file_helper.get_string();
+  auto monkey_descriptions = monkey_pattern.scan(file_helper.get_view());
 
-  boost::sregex_iterator cmd_begin(monkey_input.begin(), monkey_input.end(),
-                                   monkey_regex);
-  boost::sregex_iterator cmd_end;
-
-  std::for_each(cmd_begin, cmd_end, [&monkies](const boost::match_results<std::string::const_iterator>& m) {
-      MonkeyOp op{m["first_op_statement"], m["op_modifier"], m["second_op_statement"]};
-      Monkey mr_monkey = Monkey(m["monkey_id"].str(), m["starting_items"].str(), op, m["test_div_by"].str(), m["test_if_true"].str(), m["test_if_false"].str());
+  std::for_each(monkey_descriptions.begin(), monkey_descriptions.end(), [&monkies](const auto& m) {
+      MonkeyOp op{std::string(m[2]), std::string(m[3]), std::string(m[4])};
+      Monkey mr_monkey = Monkey(std::string(m[0]), std::string(m[1]), op, std::string(m[5]), std::string(m[6]), std::string(m[7]));
       mr_monkey.add_parent(monkies);
-      monkies->emplace(std::make_pair(m["monkey_id"].str(), mr_monkey));
+      monkies->emplace(std::make_pair(std::string(m[0]), mr_monkey));
       });
 
     return monkies;
@@ -221,6 +172,7 @@ struct Monkey {
 
 
 [[nodiscard]] size_t part1(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part1");
   auto monkies = Monkey::build_group(file_helper);
 
   for (int idx = 0; idx < 20; ++idx) {
@@ -242,15 +194,16 @@ struct Monkey {
 }
 
 [[nodiscard]] size_t part2(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part2");
   auto monkies = Monkey::build_group(file_helper);
 
-  factor = std::accumulate(std::begin(*monkies), std::end(*monkies), 1, [](const num_t& init, const auto &m){
+  num_t factor = std::accumulate(std::begin(*monkies), std::end(*monkies), num_t{1}, [](const num_t& init, const auto &m){
     return init * m.second.test_div_by;
   });
 
   for (int idx = 0; idx < 10000; ++idx) {
     for (auto& m : *monkies) {
-      m.second.inspect2();
+      m.second.inspect2(factor);
     }
   }
 
@@ -266,9 +219,25 @@ struct Monkey {
   return static_cast<size_t>(amounts[0] * amounts[1]);
 }
 
+const RegisterSolution register_part1{{11, 1, "input.txt", "56120", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper));
+}}};
+
+const RegisterSolution register_part2{{11, 2, "input.txt", "24389045529", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper));
+}}};
+} // namespace day11
+
+#ifndef AOC_NO_MAIN
+using namespace day11;
 
 int main(void) noexcept {
   FileHelper file_helper{"input.txt"};
+  if (!file_helper.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
   {
     auto result = part1(file_helper);
@@ -284,3 +253,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
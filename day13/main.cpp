@@ -4,19 +4,18 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <numeric>
-#include <sstream>
 #include <string>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <string_view>
 #include <variant>
 #include <vector>
+#include "utils.h"
+
+namespace day13 {
 
 
 class Packets;
@@ -28,35 +27,6 @@ using packets_pair_t = std::pair<Packets, Packets>;
 using packets_pair_container_t = std::vector<std::pair<Packets, Packets>>;
 using packets_variant_t = std::variant<packets_value_t, std::shared_ptr<Packets>>;
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-
-  [[nodiscard]] std::string get_string() const noexcept {
-    return std::string(input_data, s.st_size);
-  }
-};
-
 class Packets {
 public:
   std::vector<packets_variant_t> data;
@@ -65,49 +35,42 @@ public:
     data.emplace_back(v);
   }
 
-  Packets(const std::string &packets_data) {
-    std::stringstream ss{std::string{std::next(packets_data.begin(), 1), std::prev(packets_data.end(), 1)}};
+  Packets(std::string_view packets_data) {
+    std::string_view content = packets_data.substr(1, packets_data.size() - 2);
 
-    while (!ss.eof()) {
-      if (ss.peek() >= '0' && ss.peek() <= '9') {
-        //packets_variant_t num;
-        packets_value_t num;
-        ss >> num;
-        auto artifact = ss.get();
-        if (artifact != ',' && artifact != '[' && artifact != ']' && artifact != -1) {
+    size_t pos = 0;
+    while (pos < content.size()) {
+      if (content[pos] >= '0' && content[pos] <= '9') {
+        packets_value_t num{};
+        auto number_end = parse_integer(content.data() + pos, content.data() + content.size(), num);
+        pos = number_end - content.data();
+        if (pos < content.size() && content[pos] != ',') {
           assert(false);
         }
         data.push_back(num);
         continue;
       }
-      if (ss.peek() == '[') {
-        size_t nest = 1;
-        char c;
-        std::string moo;
-        while (true) {
-          c = ss.get();
-          moo.push_back(c);
-          if (c == '[') {
+      if (content[pos] == '[') {
+        size_t nest = 0;
+        size_t start = pos;
+        do {
+          if (content[pos] == '[') {
             ++nest;
           }
-          if (c == ']') {
+          if (content[pos] == ']') {
             --nest;
           }
-          if (nest == 1) {
-            data.emplace_back(std::make_shared<Packets>(moo));
-            break;
-          }
-        }
+          ++pos;
+        } while (nest > 0 && pos < content.size());
+        data.emplace_back(std::make_shared<Packets>(content.substr(start, pos - start)));
         continue;
       }
-      if (ss.peek() == ',') {
-        ss.get();
+      if (content[pos] == ',') {
+        ++pos;
         continue;
       }
-      if (ss.eof() || ss.peek() == -1) {
-        break;
-      }
       assert(false);
+      ++pos;
     }
   }
 
@@ -164,19 +127,19 @@ public:
   }
 
   static packets_pair_container_t create_all_packets(const FileHelper &file_helper) {
+    auto _ = TimeIt("create_all_packets");
     auto packets = packets_pair_container_t{};
-    auto stream = file_helper.get_stringstream();
-    while (!stream.eof()) {
-      std::string first;
-      std::getline(stream, first);
-
-      std::string second;
-      std::getline(stream, second);
-
-      packets.emplace_back(first, second);
-
-      stream.get();
-      stream.peek();
+    std::string_view first;
+    for (std::string_view line : file_helper.lines()) {
+      if (line.empty()) {
+        continue;
+      }
+      if (first.empty()) {
+        first = line;
+        continue;
+      }
+      packets.emplace_back(first, line);
+      first = {};
     }
 
     return packets;
@@ -185,6 +148,7 @@ public:
 
 
 packets_sum_t part1(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part1");
   auto result = 0;
   auto packets = Packets::create_all_packets(file_helper);
   packets_sum_t idx = 0;
@@ -206,6 +170,7 @@ packets_sum_t part1(const FileHelper &file_helper) noexcept {
 }
 
 packets_sum_t part2(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part2");
   auto result = 0;
   auto packets = Packets::create_all_packets(file_helper);
   std::vector<Packets> all_packets;
@@ -254,11 +219,26 @@ packets_sum_t part2(const FileHelper &file_helper) noexcept {
   return result;
 }
 
+const RegisterSolution register_part1{{13, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper));
+}}};
+
+const RegisterSolution register_part2{{13, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper));
+}}};
+} // namespace day13
 
+#ifndef AOC_NO_MAIN
+using namespace day13;
 
 int main(void) noexcept {
   {
     FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
 
     {
       part1(file_helper);
@@ -271,3 +251,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
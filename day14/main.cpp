@@ -4,20 +4,19 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <numeric>
-#include <sstream>
 #include <string>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <string_view>
 #include <variant>
 #include <vector>
 #include <array>
+#include "utils.h"
+
+namespace day14 {
 
 using point_t = std::uint32_t;
 using coordinates_t = std::pair<point_t, point_t>;
@@ -29,97 +28,55 @@ enum class SpaceType : std::int8_t {
   sand,
 };
 
-constexpr size_t height = 185;
-constexpr size_t width = 687;
+/* Sand pours in at x = 500 and piles up at most one column further out per row */
+constexpr point_t sand_source_x = 500;
 
-using map_t = std::array<std::array<SpaceType, width>, height>;
+/* Padded with stone so sand at the edge can look sideways without bounds checks */
+using map_t = Grid2D<SpaceType>;
+using index_t = map_t::index_t;
 
 using wall_t = std::vector<coordinates_t>;
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-
-  [[nodiscard]] std::string get_string() const noexcept {
-    return std::string(input_data, s.st_size);
-  }
-};
-
 class Location {
 public:
   map_t map;
+  /* Input x minus x_offset is the map column */
+  index_t x_offset = 0;
   size_t sand_id = 0;
   point_t max_y = 0;
 
-  Location(std::istringstream &&file_stream) {
-    auto get_if_value = [](std::istringstream &stream, std::string_view sw){
-      std::for_each(sw.cbegin(), sw.cend(), [&stream](auto c){
-        if (stream.peek() == c) {
-          stream.get();
-        }
-      });
-    };
-    std::for_each(map.begin(), map.end(), [](map_t::value_type& col){
-      col.fill(SpaceType::air);
-    });
+  Location(std::string_view input) {
+    auto _ = TimeIt("Location");
 
     std::vector<wall_t> walls;
-    wall_t wall;
-
-    while (!file_stream.eof()) {
-      if (file_stream.peek() >= '0' && file_stream.peek() <= '9') {
-        point_t n1;
-        file_stream >> n1;
-
-        auto artifact = file_stream.get();
-        if (artifact != ',' && artifact != -1) {
-          assert(false);
-        }
-
-        point_t n2;
-        file_stream >> n2;
-
-        wall.push_back(coordinates_t{n1, n2});
-
-        get_if_value(file_stream, " -> ");
-
-        continue;
+    point_t min_x = sand_source_x;
+    point_t max_x = sand_source_x;
+    point_t wall_max_y = 0;
+
+    for (std::string_view line : LineRange{input}) {
+      wall_t wall;
+      for (std::string_view point : split(line, " ->")) {
+        auto separator = point.find(',');
+        assert(separator != std::string_view::npos);
+        coordinates_t coordinates{parse_number<point_t>(point.substr(0, separator)),
+                                  parse_number<point_t>(point.substr(separator + 1))};
+        min_x = std::min(min_x, coordinates.first);
+        max_x = std::max(max_x, coordinates.first);
+        wall_max_y = std::max(wall_max_y, coordinates.second);
+        wall.push_back(coordinates);
       }
-
-      if (file_stream.peek() == 10) {
+      if (!wall.empty()) {
         walls.push_back(wall);
-        wall.clear();
-        file_stream.get();
-        continue;
       }
-
-      if (file_stream.eof() || file_stream.peek() == -1) {
-        break;
-      }
-
-      assert(false);
     }
 
+    /* Room for the floor of part 2 two rows below the lowest wall, and the pile on it */
+    index_t floor_y = static_cast<index_t>(wall_max_y) + 2;
+    index_t first_x = std::min<index_t>(min_x, sand_source_x - floor_y);
+    index_t last_x = std::max<index_t>(max_x, sand_source_x + floor_y);
+    x_offset = first_x;
+    map = map_t{last_x - first_x + 1, floor_y + 1, SpaceType::air, 1, SpaceType::stone};
+
     for (auto w : walls) {
       populate_stone_walls(w);
     }
@@ -132,14 +89,14 @@ public:
     start = w.front();
 
     for (auto it = std::next(w.cbegin(), 1); it < w.cend(); ++it) {
-      size_t start_y = std::min(start.second, ((*it).second));
-      size_t end_y = std::max(start.second, ((*it).second));
-      size_t start_x =  std::min(start.first, ((*it).first));
-      size_t end_x =  std::max(start.first, ((*it).first));
-
-      for (size_t y = start_y; y <= end_y; ++y) {
-        for (size_t x = start_x; x <= end_x; ++x) {
-          map[y][x] = SpaceType::stone;
+      index_t start_y = std::min(start.second, ((*it).second));
+      index_t end_y = std::max(start.second, ((*it).second));
+      index_t start_x = static_cast<index_t>(std::min(start.first, ((*it).first))) - x_offset;
+      index_t end_x = static_cast<index_t>(std::max(start.first, ((*it).first))) - x_offset;
+
+      for (index_t y = start_y; y <= end_y; ++y) {
+        for (index_t x = start_x; x <= end_x; ++x) {
+          map(x, y) = SpaceType::stone;
         }
       }
     start = (*it);
@@ -147,21 +104,19 @@ public:
   }
 
   void create_bottom_floor() {
-    for (size_t x = 0; x < width; ++x) {
-      assert(max_y + 2 < height && x >= 0 && x < width);
-      map[max_y + 2][x] = SpaceType::stone;
-    }
-
+    assert(max_y + 2 < map.height());
+    auto floor = map.row(max_y + 2);
+    std::fill(floor.begin(), floor.end(), SpaceType::stone);
   }
 
   void print_thing() {
-    for (size_t y = 0; y < max_y + 2; ++y) {
-      for (size_t x = 316; x < width; ++x) {
-        if (map[y][x] == SpaceType::air) {
+    for (index_t y = 0; y < max_y + 2; ++y) {
+      for (SpaceType space : map.row(y)) {
+        if (space == SpaceType::air) {
           std::cout << ".";
-        } else if (map[y][x] == SpaceType::stone) {
+        } else if (space == SpaceType::stone) {
           std::cout << "#";
-        } else if (map[y][x] == SpaceType::sand) {
+        } else if (space == SpaceType::sand) {
           std::cout << "o";
         }
       }
@@ -172,11 +127,10 @@ public:
 
   point_t get_highest_y() {
     point_t result = 0;
-    for (size_t y = 0; y < height; ++y) {
-      for (size_t x = 0; x < width; ++x) {
-        if (map[y][x] == SpaceType::stone) {
-          result = std::max<point_t>(result, y);
-        }
+    for (index_t y = 0; y < map.height(); ++y) {
+      auto row = map.row(y);
+      if (std::find(row.begin(), row.end(), SpaceType::stone) != row.end()) {
+        result = y;
       }
     }
     return result;
@@ -189,23 +143,23 @@ public:
   }
 
   bool insert_sand() {
-    size_t x = 500;
-    size_t y = 0;
-    if (map[y][x] == SpaceType::sand) {
+    index_t x = sand_source_x - x_offset;
+    index_t y = 0;
+    if (map(x, y) == SpaceType::sand) {
       return false;
     }
     while (true) {
-      if (map[y + 1][x] == SpaceType::air && !(y + 1 > 184)) {
+      assert(y + 1 < map.height());
+      if (map(x, y + 1) == SpaceType::air) {
         ++y;
-      } else if (map[y + 1][x - 1] == SpaceType::air && !(y + 1 > 184)) {
+      } else if (map(x - 1, y + 1) == SpaceType::air) {
         ++y;
         --x;
-      } else if (map[y + 1][x + 1] == SpaceType::air && !(y + 1 > 184)) {
+      } else if (map(x + 1, y + 1) == SpaceType::air) {
         ++y;
         ++x;
       } else {
-        assert(y < height && x > 0 && x < width);
-        map[y][x] = SpaceType::sand;
+        map(x, y) = SpaceType::sand;
         ++sand_id;
         return true;
       }
@@ -215,30 +169,27 @@ public:
     }
   }
 
-  bool is_above_void(size_t x, size_t y) {
-    for (size_t y_pos = y; y_pos < height; ++y_pos) {
-      if (map[y_pos][x] != SpaceType::air) {
-        return false;
-      }
-    }
-    return true;
+  bool is_above_void(index_t x, index_t y) {
+    auto column = map.column(x).subspan(y, map.height() - y);
+    return std::all_of(column.begin(), column.end(), [](SpaceType space) { return space == SpaceType::air; });
   }
 };
 
 
 result_t part1(const FileHelper &file_helper) noexcept {
-  Location l{file_helper.get_stringstream()};
+  auto _ = TimeIt("Part1");
+  Location l{file_helper.get_view()};
 
   auto result = l.solve_part1();
 
   std::printf("Part1: %lu\n", result);
 
-  assert(result == 964);
   return result;
 }
 
 result_t part2(const FileHelper &file_helper) noexcept {
-  Location l{file_helper.get_stringstream()};
+  auto _ = TimeIt("Part2");
+  Location l{file_helper.get_view()};
   l.create_bottom_floor();
   l.max_y = l.get_highest_y();
 
@@ -246,24 +197,41 @@ result_t part2(const FileHelper &file_helper) noexcept {
 
   std::printf("Part2: %lu\n", result);
 
-  assert(result == 32041);
   return result;
 }
 
+const RegisterSolution register_part1{{14, 1, "input.txt", "964", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper));
+}}};
 
+const RegisterSolution register_part2{{14, 2, "input.txt", "32041", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper));
+}}};
+} // namespace day14
+
+#ifndef AOC_NO_MAIN
+using namespace day14;
 
 int main(void) noexcept {
   {
     FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
 
     {
-      part1(file_helper);
+      [[maybe_unused]] auto result = part1(file_helper);
+      assert(result == 964);
     }
 
     {
-      part2(file_helper);
+      [[maybe_unused]] auto result = part2(file_helper);
+      assert(result == 32041);
     }
   }
 
   return EXIT_SUCCESS;
 }
+#endif
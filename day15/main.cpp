@@ -1,15 +1,9 @@
 #include <algorithm>
-#include <boost/regex.hpp>
-#include <boost/regex/v5/error_type.hpp>
-#include <boost/regex/v5/match_flags.hpp>
-#include <boost/regex/v5/regex_iterator.hpp>
-#include <boost/regex/v5/regex_match.hpp>
 #include <cassert>
 #include <compare>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
@@ -19,15 +13,13 @@
 #include <ratio>
 #include <sstream>
 #include <string>
-#include <sys/mman.h>
-#include <sys/stat.h>
 #include <typeinfo>
-#include <unistd.h>
 #include <variant>
 #include <vector>
+#include "utils.h"
 #include <array>
-#include <execution>
-#include <chrono>
+
+namespace day15 {
 
 class Beacon;
 class Sensor;
@@ -39,35 +31,6 @@ using min_max_beacons_t = std::pair<point_t, point_t>;
 using sensors_t = std::vector<Sensor>;
 
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-
-  [[nodiscard]] std::string get_string() const noexcept {
-    return std::string(input_data, s.st_size);
-  }
-};
-
 class Beacon {
 public:
   point_t x;
@@ -78,7 +41,7 @@ public:
   }
 };
 
-const boost::regex sensor_regex("Sensor at x=(?<sensor_x>-?\\d+), y=(?<sensor_y>-?\\d+): closest beacon is at x=(?<beacon_x>-?\\d+), y=(?<beacon_y>-?\\d+)");
+constexpr Pattern<"Sensor at x={i}, y={i}: closest beacon is at x={i}, y={i}"> sensor_pattern;
 
 class Sensor {
 public:
@@ -123,13 +86,12 @@ public:
   }
 
   static sensors_t create_sensors(const FileHelper& file_helper) {
-    auto input = file_helper.get_string();
-    boost::sregex_iterator cmd_begin(input.begin(), input.end(), sensor_regex);
-    boost::sregex_iterator cmd_end;
+    auto readings = sensor_pattern.scan(file_helper.get_view());
 
     sensors_t sensors;
-    std::transform(cmd_begin, cmd_end, std::back_inserter(sensors), [](const boost::sregex_iterator::value_type& m) -> Sensor{
-      return Sensor(coordinate_t{std::stoi(m["sensor_x"]), std::stoi(m["sensor_y"])}, coordinate_t{std::stoi(m["beacon_x"]), std::stoi(m["beacon_y"])});
+    std::transform(readings.begin(), readings.end(), std::back_inserter(sensors), [](const auto& m) -> Sensor{
+      return Sensor(coordinate_t{parse_number<point_t>(m[0]), parse_number<point_t>(m[1])},
+                    coordinate_t{parse_number<point_t>(m[2]), parse_number<point_t>(m[3])});
     });
 
     return sensors;
@@ -172,27 +134,28 @@ point_t loop_da_loop(const sensors_t& sensors, point_t limit) {
 
 result_t part1(const FileHelper &file_helper, const point_t y_value) noexcept {
   std::cout << "Starting part1\n";
+  auto _ = TimeIt("Part1");
   result_t result = 0;
-  sensors_t sensors = Sensor::create_sensors(file_helper);
+  sensors_t sensors = [&file_helper] {
+    auto _ = TimeIt("create_sensors");
+    return Sensor::create_sensors(file_helper);
+  }();
 
   auto min_max_x = Sensor::find_min_max_sensors_range(sensors);
 
-  auto start_time = std::chrono::system_clock::now();
-
-  for (point_t x = min_max_x.first; x <= min_max_x.second; ++x) {
-    if (std::none_of(sensors.cbegin(), sensors.cend(), [x=x,y=y_value](const sensors_t::value_type& s) -> bool {
-      return s.beacon_ptr->x == x && s.beacon_ptr->y == y;
-    }) && std::any_of(sensors.cbegin(), sensors.cend(), [x=x,y=y_value](const sensors_t::value_type& s) -> bool {
-      return s.distance_to_beacon >= s.calculate_distance_to_position(x, y);
-    })) {
-      ++result;
+  {
+    auto _ = TimeIt("scan row");
+    for (point_t x = min_max_x.first; x <= min_max_x.second; ++x) {
+      if (std::none_of(sensors.cbegin(), sensors.cend(), [x=x,y=y_value](const sensors_t::value_type& s) -> bool {
+        return s.beacon_ptr->x == x && s.beacon_ptr->y == y;
+      }) && std::any_of(sensors.cbegin(), sensors.cend(), [x=x,y=y_value](const sensors_t::value_type& s) -> bool {
+        return s.distance_to_beacon >= s.calculate_distance_to_position(x, y);
+      })) {
+        ++result;
+      }
     }
   }
 
-  auto end_time = std::chrono::system_clock::now();
-  std::chrono::duration<double> diff = end_time - start_time;
-  std::cout << "Part1 took: " << std::chrono::duration_cast<std::chrono::microseconds>(diff) << "\n";
-
   std::printf("Part1: %lu\n", result);
 
   return result;
@@ -200,28 +163,43 @@ result_t part1(const FileHelper &file_helper, const point_t y_value) noexcept {
 
 result_t part2(const FileHelper &file_helper, point_t x_and_y_limit) noexcept {
   std::cout << "Starting part2\n";
+  auto _ = TimeIt("Part2");
   result_t result = 0;
-  sensors_t sensors = Sensor::create_sensors(file_helper);
-
-  auto start_time = std::chrono::system_clock::now();
+  sensors_t sensors = [&file_helper] {
+    auto _ = TimeIt("create_sensors");
+    return Sensor::create_sensors(file_helper);
+  }();
 
-  result = loop_da_loop(sensors, x_and_y_limit);
-
-  auto end_time = std::chrono::system_clock::now();
-  std::chrono::duration<double> diff = end_time - start_time;
-
-  std::cout << "Part2 took: " << std::chrono::duration_cast<std::chrono::milliseconds>(diff) << "\n";
+  {
+    auto _ = TimeIt("loop_da_loop");
+    result = loop_da_loop(sensors, x_and_y_limit);
+  }
 
   std::printf("Part2: %lu\n", result);
 
   return result;
 }
 
+const RegisterSolution register_part1{{15, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper, 2000000));
+}}};
+
+const RegisterSolution register_part2{{15, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper, 4000000));
+}}};
+} // namespace day15
 
+#ifndef AOC_NO_MAIN
+using namespace day15;
 
 int main(void) noexcept {
   {
     FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
     constexpr point_t part1_y_value = 2000000;
     part1(file_helper, part1_y_value);
     constexpr point_t part2_x_and_y_limit = 4000000;
@@ -230,3 +208,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
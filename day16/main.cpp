@@ -1,19 +1,10 @@
 #include <algorithm>
-#include <boost/regex.hpp>
-#include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/regex/v5/error_type.hpp>
-#include <boost/regex/v5/match_flags.hpp>
-#include <boost/regex/v5/regex_iterator.hpp>
-#include <boost/regex/v5/regex_match.hpp>
 #include <cassert>
 #include <compare>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
-#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
@@ -23,17 +14,16 @@
 #include <ratio>
 #include <sstream>
 #include <string>
-#include <sys/mman.h>
-#include <sys/stat.h>
 #include <typeinfo>
-#include <unistd.h>
 #include <variant>
 #include <vector>
+#include "utils.h"
 #include <array>
-#include <execution>
 #include <chrono>
 #include <unordered_map>
 
+namespace day16 {
+
 class Valve;
 
 using valve_ptr_t = std::shared_ptr<Valve>;
@@ -46,36 +36,8 @@ using duration_t = std::int32_t;
 using steps_t = std::int32_t;
 using fluid_amount_t = std::int32_t;
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-
-  [[nodiscard]] std::string get_string() const noexcept {
-    return std::string(input_data, s.st_size);
-  }
-};
-
-const boost::regex valve_regex("Valve (?<valve_name>\\w{2}) has flow rate=(?<flow_rate>\\d+); tunnels? leads? to valves? (?<linked_to>(?:\\w{2},? ?)+)");
+/* Captures valve name, flow rate and the comma separated tunnel targets */
+constexpr Pattern<"Valve {w} has flow rate={i}; tunnels? leads? to valves? {l}"> valve_pattern;
 
 template<typename K, typename V>
 class AssignIterator {
@@ -137,23 +99,19 @@ public:
   }
 
   static valve_map_t build_valves(const FileHelper& file_helper) {
-    auto input = file_helper.get_string();
-    boost::sregex_iterator cmd_begin(input.begin(), input.end(), valve_regex);
-    boost::sregex_iterator cmd_end;
+    auto descriptions = valve_pattern.scan(file_helper.get_view());
 
     valve_map_t valves;
-    std::transform(cmd_begin, cmd_end, AssignIterator(valves), [](const boost::sregex_iterator::value_type& m) -> valve_map_t::value_type {
-      return std::pair(m["valve_name"], std::make_unique<Valve>(m["valve_name"], std::stoi(m["flow_rate"])));
+    std::transform(descriptions.begin(), descriptions.end(), AssignIterator(valves), [](const auto& m) -> valve_map_t::value_type {
+      return std::pair(std::string(m[0]), std::make_unique<Valve>(std::string(m[0]), parse_number<flow_rate_t>(m[1])));
     });
 
-    std::for_each(cmd_begin, cmd_end, [&valves](const boost::sregex_iterator::value_type& m) {
-      std::vector<std::string> split_values;
-      boost::split(split_values, m["linked_to"], boost::is_any_of(","));
-      for (std::string val : split_values) {
-        boost::trim(val);
+    std::for_each(descriptions.begin(), descriptions.end(), [&valves](const auto& m) {
+      for (std::string_view linked : split(m[2], ", ")) {
+        std::string val{linked};
         //std::cout << val << "\n";
         assert(valves.contains(val));
-        valves[m["valve_name"]]->add_child_valve(valves[val]);
+        valves[std::string(m[0])]->add_child_valve(valves[val]);
       }
     });
 
@@ -161,141 +119,43 @@ public:
   }
 };
 
-struct TimeIt {
-  std::string time_name;
-  std::chrono::system_clock::time_point start_time;
-
-  TimeIt(std::string name) :time_name(name) {
-    std::cout << "Starting timing " << time_name << "\n";
-    start_time = std::chrono::system_clock::now();
-  }
-
-  ~TimeIt() {
-    auto end_time = std::chrono::system_clock::now();
-    std::chrono::duration<double> diff = end_time - start_time;
-
-    std::cout << time_name << " took: " << std::chrono::duration_cast<std::chrono::milliseconds>(diff) << "\n";
-  }
-};
-
-struct Pathfinder {
-  using distance_t = std::int32_t;
-  struct DistanceWithPtr {
-    distance_t distance;
-    valve_ptr_t valve;
-
-    /*
-    DistanceWithPtr() {
-      assert(false);
-    }*/
-
-    /*
-    DistanceWithPtr(distance_t d, valve_ptr_t v) : distance(d), valve(v) {}
-
-    DistanceWithPtr& operator=(const DistanceWithPtr& d){
-      distance = d.distance;
-      valve = d.valve;
-      return *this;
-    }
-    */
-  };
-
-  using distance_ptr_t = std::shared_ptr<DistanceWithPtr>;
-  using distance_map_t = std::unordered_map<std::string, std::shared_ptr<DistanceWithPtr>>;
-
-  using distance_vector_t = std::vector<std::shared_ptr<DistanceWithPtr>>;
-
-  distance_map_t visited;
-  distance_vector_t to_traverse;
-
-  Pathfinder(const valve_ptr_t& v) {
-    assert(v.get() != nullptr);
-    //std::cout << v.get()->name << "\n";
-    auto distance_to_start = DistanceWithPtr{0, v};
-    assert(distance_to_start.valve.get() != nullptr);
-    //std::cout << "Constructor Pathfinder: " << to_traverse.size() << "\n";
-    to_traverse.emplace_back(std::make_shared<DistanceWithPtr>(distance_to_start));
-  }
-
-  void step() {
-    std::sort(to_traverse.begin(), to_traverse.end(), [](const auto& v1, const auto& v2 ){
-      return v1->distance > v2->distance;
-    });
-
-    auto d = to_traverse.back();
-    assert(d->valve.get() != nullptr);
-    //std::cout << "Pathfinder::step: " << to_traverse.size() << "\n";
-
-    traverse(d);
-  }
-
-  std::shared_ptr<DistanceWithPtr> step_until_found(const valve_ptr_t& v) {
-    while (true) {
-      if(visited.contains(v->name)) {
-        auto temp_dist = visited[v->name];
-        return temp_dist;
+/* Valves numbered in the order the map hands them out, tunnels as lists of those numbers */
+using tunnel_search_t = GraphSearch<std::uint32_t, std::uint32_t>;
+using valve_ids_t = std::unordered_map<std::string, tunnel_search_t::node_t>;
+using tunnels_t = std::vector<std::vector<tunnel_search_t::node_t>>;
 
-      }
-
-      assert(to_traverse.size() > 0);
-
-      step();
-    }
-
-    assert(false);
-  }
-
-  void traverse(const distance_ptr_t& start) {
-    for (auto child_ptr : start->valve->linked_valves) {
-      auto child = std::shared_ptr<Valve>(child_ptr.second);
-      auto distance_to_child = std::make_shared<DistanceWithPtr>(start->distance+1, child);
-      to_traverse.emplace_back(distance_to_child);
-      assert(distance_to_child.get() != 0 || distance_to_child.get() != nullptr);
-      //std::cout << "Pathfinder::traverse: " << to_traverse.size() << "\n";
-    }
-
-    visited[start->valve->name] = start;
-
-    to_traverse.erase(std::remove_if(to_traverse.begin(), to_traverse.end(), [name=start->valve->name](const distance_vector_t::value_type& d) -> bool {
-      if (d->valve == nullptr) {
-        return true;
-      }
-      return d->valve->name == name;
-    }), to_traverse.end());
-
-  }
-
-};
-
-struct hash_pair {
-  template <class T1, class T2>
-  size_t operator()(const std::pair<T1, T2>& p) const
-  {
-    auto hash1 = std::hash<T1>{}(p.first);
-    auto hash2 = std::hash<T2>{}(p.second);
-
-    if (hash1 != hash2) {
-        return hash1 ^ hash2;
-    }
-
-    // If hash1 == hash2, their XOR is zero.
-      return hash1;
-  }
-};
-
-using hash_pair_t = std::string;
-using cache_map_t = std::unordered_map<hash_pair_t, steps_t>;
-cache_map_t cached_distance{};
+/* Keyed on the start and target valve ids packed together */
+using cache_map_t = FlatHashMap<std::uint64_t, steps_t>;
 
 struct SolverBase {
   valve_map_t valves;
   valve_ptr_t current_valve;
   weak_valve_map_t all_working_valves;
+  valve_ids_t valve_ids;
+  tunnels_t tunnels;
+  /*
+   * Tunnel distances, per solver so solvers can run on separate threads.
+   * Filled in by warm_distance_cache() before a solver goes parallel, after
+   * which lookups only read it.
+   */
+  mutable cache_map_t cached_distance;
 
   SolverBase(const FileHelper &file_helper) {
+    auto _ = TimeIt("SolverBase");
     valves = Valve::build_valves(file_helper);
     current_valve = valves["AA"];
     all_working_valves = get_all_working_valves();
+
+    for (const auto &v : valves) {
+      valve_ids.emplace(v.first, static_cast<tunnel_search_t::node_t>(valve_ids.size()));
+    }
+    tunnels.resize(valve_ids.size());
+    for (const auto &v : valves) {
+      auto &targets = tunnels[valve_ids.at(v.first)];
+      for (const auto &linked : v.second->linked_valves) {
+        targets.push_back(valve_ids.at(linked.first));
+      }
+    }
   }
 
   weak_valve_map_t get_all_working_valves() const {
@@ -310,16 +170,40 @@ struct SolverBase {
   }
 
   steps_t get_distance_to(std::shared_ptr<Valve> start, std::shared_ptr<Valve> target) const {
-    auto key = hash_pair_t{start->name + target->name};
-    if (cached_distance.contains(key)) {
-      return cached_distance.at(key);
+    auto start_id = valve_ids.at(start->name);
+    auto target_id = valve_ids.at(target->name);
+    auto key = pack_2d(static_cast<std::int32_t>(start_id), static_cast<std::int32_t>(target_id));
+    if (const auto *cached = cached_distance.find(key)) {
+      return *cached;
     }
-    Pathfinder p{start};
+    auto _ = TimeIt("pathfinder");
+    tunnel_search_t search{tunnels.size()};
+    search.add_source(start_id);
+
+    [[maybe_unused]] auto found = search.bfs(
+      [this](tunnel_search_t::node_t valve, auto &&emit) {
+        for (auto next : tunnels[valve]) {
+          emit(next);
+        }
+      },
+      [target_id](tunnel_search_t::node_t valve) { return valve == target_id; });
+    assert(found);
 
-    auto d = p.step_until_found(target);
+    auto distance = static_cast<steps_t>(search.distance(target_id));
+    cached_distance[key] = distance;
+    return distance;
+  }
 
-    cached_distance[key] = d->distance;
-    return d->distance;
+  /* Every distance the solvers can ask for, from the start or a working valve to a working valve */
+  void warm_distance_cache() const {
+    auto _ = TimeIt("warm_distance_cache");
+    cached_distance.reserve((all_working_valves.size() + 1) * all_working_valves.size());
+    for (const auto &target : all_working_valves) {
+      [[maybe_unused]] auto from_start = get_distance_to(current_valve, target.second.lock());
+      for (const auto &start : all_working_valves) {
+        [[maybe_unused]] auto distance = get_distance_to(start.second.lock(), target.second.lock());
+      }
+    }
   }
 
   void get_most_yeild() {
@@ -387,14 +271,20 @@ struct Solver1 : SolverBase{
 
     //get_most_yeild();
 
-    for (auto v : all_working_valves) {
-      Runner r(current_valve, all_working_valves, *this);
-      r.parent = *this;
-
-      auto f = r.recursive_solver(v.second);
-      result = std::max(f, result);
+    warm_distance_cache();
+    std::vector<weak_valve_ptr_t> first_targets;
+    for (const auto &v : all_working_valves) {
+      first_targets.push_back(v.second);
     }
 
+    result = ExecutionContext::global().parallel_reduce(
+      first_targets.size(), result,
+      [&](size_t idx) {
+        Runner r(current_valve, all_working_valves, *this);
+        return r.recursive_solver(first_targets[idx]);
+      },
+      [](flow_rate_t f1, flow_rate_t f2) { return std::max(f1, f2); });
+
     std::printf("Part1: %d\n", result);
 
     return result;
@@ -520,19 +410,30 @@ struct Solver2 :SolverBase {
     auto _ = TimeIt("Part2");
     flow_rate_t result = 0;
 
+    warm_distance_cache();
+    std::vector<std::pair<weak_valve_ptr_t, weak_valve_ptr_t>> first_targets;
     for (auto it = all_working_valves.begin(); it != std::next(all_working_valves.begin(), all_working_valves.size() - 1); ++it) {
       for (auto it2 = std::next(it, 1); it2 != all_working_valves.end(); ++it2) {
+        first_targets.emplace_back((*it).second, (*it2).second);
+      }
+    }
+
+    /* Printed afterwards so the output keeps its order however the pairs were scheduled */
+    std::vector<flow_rate_t> finished(first_targets.size());
+    ExecutionContext::global().parallel_for(first_targets.size(), [&](size_t begin, size_t end) {
+      for (size_t idx = begin; idx < end; ++idx) {
+        auto &[first, second] = first_targets[idx];
         Runner2 r(current_valve, all_working_valves, *this);
-        r.parent = *this;
-        r.first_finished = get_distance_to(current_valve, (*it).second.lock());
-        r.second_finished = get_distance_to(current_valve, (*it2).second.lock());
-        r.first_current_valve = (*it).second.lock();
-        r.second_current_valve = (*it2).second.lock();
-        auto f = r.recursive_solver((*it).second, (*it2).second);
-        assert(f <= 2536);
-        std::cout << "FIN: " << f << "\n";
-        result = std::max(f, result);
+        r.first_finished = get_distance_to(current_valve, first.lock());
+        r.second_finished = get_distance_to(current_valve, second.lock());
+        r.first_current_valve = first.lock();
+        r.second_current_valve = second.lock();
+        finished[idx] = r.recursive_solver(first, second);
       }
+    });
+    for (auto f : finished) {
+      std::cout << "FIN: " << f << "\n";
+      result = std::max(f, result);
     }
 
     std::printf("Part2: %d\n", result);
@@ -541,15 +442,36 @@ struct Solver2 :SolverBase {
   }
 };
 
+const RegisterSolution register_part1{{16, 1, "input.txt", "1857", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver1 solver{file_helper};
+  return std::to_string(solver());
+}}};
+
+const RegisterSolution register_part2{{16, 2, "input.txt", "2536", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver2 solver{file_helper};
+  return std::to_string(solver());
+}}};
+} // namespace day16
+
+#ifndef AOC_NO_MAIN
+using namespace day16;
 
 int main(void) noexcept {
   {
     FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
     Solver1 s1{file_helper};
-    assert(s1() == 1857);
+    [[maybe_unused]] auto result1 = s1();
+    assert(result1 == 1857);
     Solver2 s2{file_helper};
-    assert(s2() == 2536);
+    [[maybe_unused]] auto result2 = s2();
+    assert(result2 == 2536);
   }
 
   return EXIT_SUCCESS;
 }
+#endif
@@ -9,12 +9,14 @@
 #include <iterator>
 #include <memory>
 
+namespace day17 {
+
 using cavern_height_t = std::uint64_t;
 using cave_point_t = std::int64_t;
 using height_t = std::int64_t;
 using width_t = std::int64_t;
 using rock_particle_t = char;
-using cave_t = std::vector<std::string>;
+using cave_t = Grid2D<rock_particle_t>;
 
 class Rock {
 public:
@@ -62,57 +64,56 @@ struct RockPosition {
   }
 };
 
+/*
+ * The chamber grows upwards from y = 0 at the floor, so new rows are only ever
+ * appended. It is padded with walls, the floor included, which is what stops
+ * a falling rock at the sides and the bottom.
+ */
 struct Cavern {
   enum class Direction : std::int8_t {
     Down,
     Right,
     Left,
   };
+  static constexpr width_t chamber_width = 7;
+  static constexpr rock_particle_t wall = '|';
+
+  /* Bottom left corner of the falling rock */
   RockPosition position;
-  std::shared_ptr<Rock> rock;
-  height_t top_rock_position = 0;
+  std::shared_ptr<const Rock> rock;
+  height_t tower_height = 0;
 
-  cave_t cave;
+  cave_t cave{chamber_width, 0, ' ', 1, wall};
 
-  void add_rock(const std::shared_ptr<Rock> r) {
-    if (r->get_height() + 3 > top_rock_position) {
-      auto to_add = (r->get_height() + 3) - top_rock_position;
-      for (size_t idx = 0; idx < to_add; ++idx) {
-        cave.insert(cave.begin(), std::string(7, ' '));
-        ++top_rock_position;
-      }
-    }
-    rock = r;
-    position = RockPosition{2, top_rock_position - (3 + r->get_height())};
+  /* Rows between the top of the chamber and the top of the tower */
+  height_t top_rock_position() const {
+    return cave.height() - tower_height;
   }
 
-  height_t calculate_top_rock_position() const {
-    height_t top = 0;
-    for (size_t y = std::min(static_cast<size_t>(top_rock_position), cave.size() - 1); y >= 0; --y) {
-      for (size_t x = 0; x < cave[0].size(); ++x) {
-        if (cave[y][x] == '#') {
-          top = y;
-          break;
-        }
-      }
-      if (top != static_cast<height_t>(y)) {
-        return top;
-      }
+  void add_rock(const std::shared_ptr<const Rock> &r) {
+    height_t needed = tower_height + 3 + r->get_height();
+    if (needed > cave.height()) {
+      cave.append_rows(needed - cave.height(), ' ');
     }
-    return top;
+    rock = r;
+    position = RockPosition{2, tower_height + 3};
   }
 
+  /* Rock pattern rows are listed top first */
+  bool is_rock(width_t x, height_t y) const {
+    return (*rock).rock_pattern[rock->get_height() - 1 - y][x] == '#';
+  }
 
   void place_rock() {
-    for (size_t y = 0; y < rock->get_height(); ++y) {
-      for (size_t x = 0; x < rock->get_width(); ++x) {
-          if ((*rock).rock_pattern[y][x] == '#') {
-            cave[y + position.y][x + position.x] = '#';
+    for (height_t y = 0; y < rock->get_height(); ++y) {
+      for (width_t x = 0; x < rock->get_width(); ++x) {
+          if (is_rock(x, y)) {
+            cave(x + position.x, y + position.y) = '#';
           }
       }
     }
 
-    top_rock_position = calculate_top_rock_position();
+    tower_height = std::max(tower_height, position.y + rock->get_height());
   }
 
   bool move(Direction d) {
@@ -127,9 +128,10 @@ struct Cavern {
   }
 
   bool can_move(Direction d) {
-    for (int y = 0; y < rock->get_height(); ++y) {
-      for (int x = 0; x < rock->get_width(); ++x) {
-        if ((*rock).rock_pattern[y][x] == '#' && !can_move(RockPosition{position.x+x,position.y+y}, d)) {
+    auto offset = get_offset(d);
+    for (height_t y = 0; y < rock->get_height(); ++y) {
+      for (width_t x = 0; x < rock->get_width(); ++x) {
+        if (is_rock(x, y) && cave(position.x + x + offset.x, position.y + y + offset.y) != ' ') {
           return false;
         }
       }
@@ -137,25 +139,9 @@ struct Cavern {
     return true;
   }
 
-  bool can_move(RockPosition p, Direction d) {
-    auto offset = get_offset(d);
-    cave_point_t target_x = p.x + offset.x;
-    cave_point_t target_y = p.y + offset.y;
-    if (target_x > 7 || target_x < 0) {
-      return false;
-    }
-    if (static_cast<size_t>(target_y) >= cave.size()) {
-      return false;
-    }
-    if (cave[target_y][target_x] != ' ') {
-      return false;
-    }
-    return true;
-  }
-
   RockPosition get_offset(Direction d) {
     if (d == Direction::Down) {
-      return RockPosition{0, 1};
+      return RockPosition{0, -1};
     }
     if (d == Direction::Left) {
       return RockPosition{-1, 0};
@@ -163,24 +149,24 @@ struct Cavern {
     if (d == Direction::Right) {
       return RockPosition{1, 0};
     }
-    return RockPosition{0, 1};
+    return RockPosition{0, -1};
   }
 
   void print_debug() {
     std::cout << "Begin print debug!\n";
 
-    for (int y = 0; y < cave.size(); ++y) {
+    for (height_t y = cave.height() - 1; y >= 0; --y) {
       std::cout << "|";
-      for (int x = 0; x < cave[y].size(); ++x) {
+      for (width_t x = 0; x < chamber_width; ++x) {
         if ((x >= position.x && x < position.x + rock->get_width()) && (y >= position.y && y < position.y + rock->get_height())) {
-          if ((*rock).rock_pattern[y - position.y][x - position.x] == '#') {
+          if (is_rock(x - position.x, y - position.y)) {
             std::cout << "#";
           } else {
             std::cout << " ";
           }
 
         } else {
-          std::cout << cave[y][x];
+          std::cout << cave(x, y);
         }
       }
       std::cout << "|\n";
@@ -189,21 +175,29 @@ struct Cavern {
     std::cout << "End print debug!\n";
   }
 
+  bool same_row(height_t y1, height_t y2) const {
+    auto row1 = cave.row(y1);
+    auto row2 = cave.row(y2);
+    return std::equal(row1.begin(), row1.end(), row2.begin());
+  }
+
+  /* Looks for the tower repeating itself, reported as rows counted from the top of the chamber */
   size_t find_repeating() const {
-    for (size_t y = cave.size() - 1; y > 0; --y) {
-      for (size_t offset = 1; offset < y; ++offset) {
+    height_t rows = cave.height();
+    for (height_t y = 0; y < rows - 1; ++y) {
+      for (height_t offset = 1; offset < rows - 1 - y; ++offset) {
         size_t match_count = 0;
-        if (cave[y] == cave[y - offset]) {
-          for (size_t idx = 0; idx < offset; ++idx) {
-            if (cave[y - idx] == cave[y - offset - idx]) {
+        if (same_row(y, y + offset)) {
+          for (height_t idx = 0; idx < offset && y + offset + idx < rows; ++idx) {
+            if (same_row(y + idx, y + offset + idx)) {
               ++match_count;
             } else {
               break;
             }
           }
         if (match_count > 1000) {
-          std::cout << "Match: " << match_count << " offset: " << offset << " y: " << y <<  "\n";
-          if (match_count == offset) {
+          std::cout << "Match: " << match_count << " offset: " << offset << " y: " << rows - 1 - y <<  "\n";
+          if (match_count == static_cast<size_t>(offset)) {
             return match_count;
           }
         }
@@ -215,8 +209,40 @@ struct Cavern {
 
 };
 
+using rocks_t = std::vector<std::shared_ptr<const Rock>>;
+
+/* The five rock shapes in the order they fall, built once and shared by every solver */
+const rocks_t &rock_table() {
+  static const rocks_t rocks{
+    std::make_shared<const Rock>(std::initializer_list<std::string>{
+      {std::string{"####"}},
+    }),
+    std::make_shared<const Rock>(std::initializer_list<std::string>{
+      {std::string{".#."}},
+      {std::string{"###"}},
+      {std::string{".#."}},
+    }),
+    std::make_shared<const Rock>(std::initializer_list<std::string>{
+      {std::string{"..#"}},
+      {std::string{"..#"}},
+      {std::string{"###"}},
+    }),
+    std::make_shared<const Rock>(std::initializer_list<std::string>{
+      {std::string{"#"}},
+      {std::string{"#"}},
+      {std::string{"#"}},
+      {std::string{"#"}},
+    }),
+    std::make_shared<const Rock>(std::initializer_list<std::string>{
+      {std::string{"##"}},
+      {std::string{"##"}},
+    }),
+  };
+  return rocks;
+}
+
 struct SolverBase {
-  std::vector<std::shared_ptr<Rock>> rocks;
+  const rocks_t &rocks = rock_table();
   std::string jet_stream;
   Cavern cave;
 
@@ -238,30 +264,6 @@ struct SolverBase {
 
   SolverBase(const FileHelper &file_helper) {
   auto _ = TimeIt("SolverBase");
-  rocks.emplace_back(new Rock({
-      {std::string{"####"}},
-      }));
-  rocks.emplace_back(new Rock({
-        {std::string{".#."}},
-        {std::string{"###"}},
-        {std::string{".#."}},
-      }));
-  rocks.emplace_back(new Rock({
-        {std::string{"..#"}},
-        {std::string{"..#"}},
-        {std::string{"###"}},
-      }));
-  rocks.emplace_back(new Rock({
-        {std::string{"#"}},
-        {std::string{"#"}},
-        {std::string{"#"}},
-        {std::string{"#"}},
-      }));
-  rocks.emplace_back(new Rock({
-        {std::string{"##"}},
-        {std::string{"##"}},
-      }));
-
     std::getline(file_helper.get_stringstream(), jet_stream);
     //std::cout << jet_stream << "\n";
     for (const auto& r: rocks) {
@@ -294,7 +296,7 @@ struct Solver1 : public SolverBase{
       //cave.print_debug();
     }
 
-    result = cave.cave.size() - cave.calculate_top_rock_position();
+    result = cave.tower_height;
 
     std::printf("%s: %ld\n", solver_name.c_str(), result);
 
@@ -311,7 +313,7 @@ struct Solver2 :SolverBase {
     auto _ = TimeIt(solver_name);
     height_t result = 0;
     for (size_t idx = 0; idx < piece_count; ++idx) {
-      if (cave.top_rock_position == (cave.cave.size() - 131 - 1) || cave.top_rock_position == (cave.cave.size() - (131 + 2702 - 1))) {
+      if (cave.top_rock_position() == (cave.cave.height() - 131 - 1) || cave.top_rock_position() == (cave.cave.height() - (131 + 2702 - 1))) {
         std::cout << idx << "\n";
       }
 
@@ -322,9 +324,8 @@ struct Solver2 :SolverBase {
       while(true) {
         if (!cave.move(get_direction())) {
           cave.place_rock();
-      if (cave.top_rock_position == 131 || cave.top_rock_position == 131 + 2702) {
+      if (cave.top_rock_position() == 131 || cave.top_rock_position() == 131 + 2702) {
         std::cout << idx << "\n";
-        std::cin.get();
       }
           break;
         }
@@ -338,7 +339,7 @@ struct Solver2 :SolverBase {
     size_t kappa_val = (kek_val - (kek_val % 1721)) / 1721;
     std::cout << kappa_val << "\n";
     std::cout << kappa_val * 2702 << "\n";
-    result = cave.cave.size() - cave.calculate_top_rock_position();
+    result = cave.tower_height;
 
     std::printf("%s: %ld\n", solver_name.c_str(), result);
 
@@ -346,10 +347,28 @@ struct Solver2 :SolverBase {
   }
 };
 
+const RegisterSolution register_part1{{17, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver1 solver{file_helper};
+  return std::to_string(solver());
+}}};
+
+const RegisterSolution register_part2{{17, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver2 solver{file_helper};
+  return std::to_string(solver());
+}}};
+} // namespace day17
+
+#ifndef AOC_NO_MAIN
+using namespace day17;
 
 int main(void) noexcept {
   {
     FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
     Solver1 s1{file_helper};
     s1();
     Solver2 s2{file_helper};
@@ -358,3 +377,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+namespace day18 {
+
+using coordinate_t = std::int32_t;
+using area_t = std::uint64_t;
+using cube_key_t = std::uint64_t;
+using cube_set_t = FlatHashSet<cube_key_t>;
+
+struct Cube {
+  coordinate_t x;
+  coordinate_t y;
+  coordinate_t z;
+};
+
+constexpr std::array<Cube, 6> face_offsets{{
+  {1, 0, 0},
+  {-1, 0, 0},
+  {0, 1, 0},
+  {0, -1, 0},
+  {0, 0, 1},
+  {0, 0, -1},
+}};
+
+struct SolverBase {
+  std::vector<Cube> cubes;
+  cube_set_t cube_set;
+
+  SolverBase(const FileHelper &file_helper) {
+    auto _ = TimeIt("SolverBase");
+    std::vector<coordinate_t> values;
+    append_integers(file_helper.get_view(), values);
+    assert(values.size() % 3 == 0);
+
+    cubes.reserve(values.size() / 3);
+    std::vector<cube_key_t> keys;
+    keys.reserve(values.size() / 3);
+    for (size_t idx = 0; idx + 2 < values.size(); idx += 3) {
+      cubes.push_back({values[idx], values[idx + 1], values[idx + 2]});
+      keys.push_back(pack_3d(values[idx], values[idx + 1], values[idx + 2]));
+    }
+    cube_set.insert(keys.begin(), keys.end());
+  }
+
+  [[nodiscard]] bool is_cube(coordinate_t x, coordinate_t y, coordinate_t z) const {
+    return cube_set.contains(pack_3d(x, y, z));
+  }
+};
+
+struct Solver1 : public SolverBase {
+  std::string solver_name = "Part1";
+  area_t operator()() noexcept {
+    auto _ = TimeIt(solver_name);
+    area_t result = 0;
+
+    for (const auto &cube : cubes) {
+      for (const auto &offset : face_offsets) {
+        if (!is_cube(cube.x + offset.x, cube.y + offset.y, cube.z + offset.z)) {
+          ++result;
+        }
+      }
+    }
+
+    std::printf("%s: %lu\n", solver_name.c_str(), result);
+
+    return result;
+  }
+};
+
+/*
+ * Floods the air around the droplet from every cell on the outside of its
+ * bounding box, grown by one so the flood can get all the way round, and
+ * counts the cube faces the flood touches.
+ */
+struct Solver2 : public SolverBase {
+  using search_t = GraphSearch<std::uint32_t, std::uint32_t>;
+
+  std::string solver_name = "Part2";
+  Cube low{};
+  Cube size{};
+
+  [[nodiscard]] search_t::node_t node(coordinate_t x, coordinate_t y, coordinate_t z) const noexcept {
+    return static_cast<search_t::node_t>(((x - low.x) * size.y + (y - low.y)) * size.z + (z - low.z));
+  }
+
+  [[nodiscard]] Cube position(search_t::node_t id) const noexcept {
+    auto index = static_cast<coordinate_t>(id);
+    return {index / (size.y * size.z) + low.x, (index / size.z) % size.y + low.y, index % size.z + low.z};
+  }
+
+  area_t operator()() noexcept {
+    auto _ = TimeIt(solver_name);
+    area_t result = 0;
+    if (cubes.empty()) {
+      std::printf("%s: %lu\n", solver_name.c_str(), result);
+      return result;
+    }
+
+    Cube high{std::numeric_limits<coordinate_t>::min(), std::numeric_limits<coordinate_t>::min(),
+              std::numeric_limits<coordinate_t>::min()};
+    low = {std::numeric_limits<coordinate_t>::max(), std::numeric_limits<coordinate_t>::max(),
+           std::numeric_limits<coordinate_t>::max()};
+    for (const auto &cube : cubes) {
+      low = {std::min(low.x, cube.x - 1), std::min(low.y, cube.y - 1), std::min(low.z, cube.z - 1)};
+      high = {std::max(high.x, cube.x + 1), std::max(high.y, cube.y + 1), std::max(high.z, cube.z + 1)};
+    }
+    size = {high.x - low.x + 1, high.y - low.y + 1, high.z - low.z + 1};
+
+    search_t search{static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * static_cast<size_t>(size.z)};
+    for (coordinate_t x = low.x; x <= high.x; ++x) {
+      for (coordinate_t y = low.y; y <= high.y; ++y) {
+        for (coordinate_t z = low.z; z <= high.z; ++z) {
+          if (x == low.x || x == high.x || y == low.y || y == high.y || z == low.z || z == high.z) {
+            search.add_source(node(x, y, z));
+          }
+        }
+      }
+    }
+
+    search.bfs([&](search_t::node_t id, auto &&emit) {
+      Cube air = position(id);
+      for (const auto &offset : face_offsets) {
+        Cube next{air.x + offset.x, air.y + offset.y, air.z + offset.z};
+        if (next.x < low.x || next.y < low.y || next.z < low.z || next.x > high.x || next.y > high.y ||
+            next.z > high.z) {
+          continue;
+        }
+        if (!is_cube(next.x, next.y, next.z)) {
+          emit(node(next.x, next.y, next.z));
+        }
+      }
+    });
+
+    /* Every neighbour of a cube lies inside the grown box */
+    for (const auto &cube : cubes) {
+      for (const auto &offset : face_offsets) {
+        if (search.settled(node(cube.x + offset.x, cube.y + offset.y, cube.z + offset.z))) {
+          ++result;
+        }
+      }
+    }
+
+    std::printf("%s: %lu\n", solver_name.c_str(), result);
+
+    return result;
+  }
+};
+
+const RegisterSolution register_part1{{18, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver1 solver{file_helper};
+  return std::to_string(solver());
+}}};
+
+const RegisterSolution register_part2{{18, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver2 solver{file_helper};
+  return std::to_string(solver());
+}}};
+} // namespace day18
+
+#ifndef AOC_NO_MAIN
+using namespace day18;
+
+int main(void) noexcept {
+  {
+    FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
+    Solver1 s1{file_helper};
+    s1();
+    Solver2 s2{file_helper};
+    s2();
+  }
+
+  return EXIT_SUCCESS;
+}
+#endif
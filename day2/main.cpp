@@ -1,87 +1,218 @@
+#include <array>
+#include <cinttypes>
+#include <cstdint>
 #include <cstdio>
-#include <fstream>
+#include <cstdlib>
 #include <string>
+#include <string_view>
+#include "utils.h"
 
-struct Strat {
-  char m_opponent;
-  char m_you;
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
-  int m_opponent_score = 0;
-  int m_your_score = 0;
+namespace day2 {
+/*
+ * Every round is "A X\n": the opponent's shape A, B or C and the second
+ * column X, Y or Z. The low two bits of those letters are 1 to 3 and 0 to 2,
+ * so (opponent & 3) << 2 | (column & 3) indexes a round in a 16 entry table
+ * without any parsing. Entries no round can reach score 0.
+ */
+[[nodiscard]] constexpr unsigned round_index(char opponent, char column) noexcept {
+  return ((static_cast<unsigned>(opponent) & 3) << 2) | (static_cast<unsigned>(column) & 3);
+}
+
+using ScoreTable = std::array<std::uint8_t, 16>;
 
-  bool winning_move(int o, int y) {
-    return (((o % 3) & y) == y) && (((o % 3) == 0) == (y == 0));
+/* shape(opponent, column) is the shape played, 0 rock, 1 paper, 2 scissors */
+template <typename Shape>
+[[nodiscard]] constexpr ScoreTable make_score_table(Shape shape) noexcept {
+  ScoreTable table{};
+  for (int opponent = 0; opponent < 3; ++opponent) {
+    for (int column = 0; column < 3; ++column) {
+      int you = shape(opponent, column);
+      /* 0 loss, 1 draw, 2 win */
+      int outcome = (you - opponent + 4) % 3;
+      table[round_index(static_cast<char>('A' + opponent), static_cast<char>('X' + column))] =
+        static_cast<std::uint8_t>(you + 1 + 3 * outcome);
+    }
   }
+  return table;
+}
 
-  void calculate_score_v1() {
-    m_opponent_score = m_opponent & 3;
-    m_your_score = (m_you& 3) + 1;
+/* The column is the shape to play */
+constexpr ScoreTable score_v1 = make_score_table([](int, int column) { return column; });
+/* The column is the outcome to aim for, the shape follows from it */
+constexpr ScoreTable score_v2 = make_score_table([](int opponent, int column) { return (opponent + column + 2) % 3; });
 
-    bool is_same = m_opponent_score == m_your_score;
-    bool you_winner = winning_move(m_opponent & 3, m_you& 3);
+struct Totals {
+  std::uint64_t v1 = 0;
+  std::uint64_t v2 = 0;
+};
 
-    m_opponent_score += is_same ? 3 : (!you_winner ? 6 : 0);
-    m_your_score += is_same ? 3 : (you_winner ? 6 : 0);
+/* Scores lines one at a time, skipping any that are too short to be a round */
+void score_lines(std::string_view lines, Totals &totals) noexcept {
+  for (std::string_view line : LineRange{lines}) {
+    if (line.size() < 3) {
+      continue;
+    }
+    unsigned index = round_index(line[0], line[2]);
+    totals.v1 += score_v1[index];
+    totals.v2 += score_v2[index];
   }
+}
 
-  void calculate_score_v2() {
-    switch (m_you) {
-    case 'X':
-      m_opponent_score = (m_opponent & 3) + 6;
-      for (int i = 0; i < 3; ++i) {
-        if ((i + 1) != (m_opponent & 3) && winning_move((i + 1), (m_opponent & 3) - 1)) {
-          m_your_score = i + 1;
-          break;
-        }
-      }
-      break;
-    case 'Y':
-      m_opponent_score = (m_opponent & 3) + 3;
-      m_your_score = (m_opponent & 3) + 3;
-      break;
-    case 'Z':
-      m_opponent_score = (m_opponent & 3);
-      for (int i = 0; i < 3; ++i) {
-        if ((i + 1) != (m_opponent & 3) && winning_move((m_opponent & 3), i)) {
-          m_your_score = i + 7;
-          break;
-        }
-      }
+/*
+ * A kernel scores whole vectors of rounds from the start of lines for as
+ * long as every round in a vector has the "A X\n" shape, and returns how many
+ * bytes it scored. score_lines() takes it from there.
+ */
+using kernel_t = size_t (*)(std::string_view, Totals &);
+
+[[nodiscard]] size_t score_scalar(std::string_view, Totals &) noexcept {
+  return 0;
+}
+
+#if defined(__x86_64__)
+/*
+ * Both kernels look at a round as the 32 bit lane "A X\n". One pshufb per
+ * table turns the lane's index byte into its score, and psadbw adds the
+ * scores up into 64 bit sums.
+ */
+[[nodiscard]] inline std::uint64_t horizontal_sum(__m128i sums) noexcept {
+  return static_cast<std::uint64_t>(_mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+}
+
+[[nodiscard]] __attribute__((target("ssse3"))) size_t score_ssse3(std::string_view lines, Totals &totals) noexcept {
+  const __m128i table_v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(score_v1.data()));
+  const __m128i table_v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(score_v2.data()));
+  const __m128i separators = _mm_set1_epi32(0x0a002000);
+  const __m128i low_bits = _mm_set1_epi32(0x00030003);
+  const __m128i index_mask = _mm_set1_epi32(0x0f);
+  __m128i sum_v1 = _mm_setzero_si128();
+  __m128i sum_v2 = _mm_setzero_si128();
+
+  size_t offset = 0;
+  for (; offset + sizeof(__m128i) <= lines.size(); offset += sizeof(__m128i)) {
+    __m128i rounds = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lines.data() + offset));
+    if ((_mm_movemask_epi8(_mm_cmpeq_epi8(rounds, separators)) & 0xaaaa) != 0xaaaa) {
       break;
     }
+    __m128i bits = _mm_and_si128(rounds, low_bits);
+    __m128i index = _mm_and_si128(_mm_or_si128(_mm_slli_epi32(bits, 2), _mm_srli_epi32(bits, 16)), index_mask);
+    sum_v1 = _mm_add_epi64(sum_v1, _mm_sad_epu8(_mm_shuffle_epi8(table_v1, index), _mm_setzero_si128()));
+    sum_v2 = _mm_add_epi64(sum_v2, _mm_sad_epu8(_mm_shuffle_epi8(table_v2, index), _mm_setzero_si128()));
   }
-};
 
-std::istream &operator>>(std::istream &is, Strat &s) {
-  s.m_opponent = is.get();
-  is.get();
-  s.m_you= is.get();
-  is.get();
-  return is;
+  totals.v1 += horizontal_sum(sum_v1);
+  totals.v2 += horizontal_sum(sum_v2);
+  return offset;
 }
 
-int main(void) {
-  {
-    std::ifstream fs("input.txt", fs.in);
+[[nodiscard]] __attribute__((target("avx2"))) size_t score_avx2(std::string_view lines, Totals &totals) noexcept {
+  /* vpshufb looks up within each 128 bit half, so both halves get the table */
+  const __m256i table_v1 =
+    _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(score_v1.data())));
+  const __m256i table_v2 =
+    _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(score_v2.data())));
+  const __m256i separators = _mm256_set1_epi32(0x0a002000);
+  const __m256i low_bits = _mm256_set1_epi32(0x00030003);
+  const __m256i index_mask = _mm256_set1_epi32(0x0f);
+  __m256i sum_v1 = _mm256_setzero_si256();
+  __m256i sum_v2 = _mm256_setzero_si256();
 
-    int myTotal = 0;
-    for (Strat s; fs >> s; ) {
-      s.calculate_score_v1();
-      myTotal += s.m_your_score;
+  size_t offset = 0;
+  for (; offset + sizeof(__m256i) <= lines.size(); offset += sizeof(__m256i)) {
+    __m256i rounds = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lines.data() + offset));
+    auto matched = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(rounds, separators)));
+    if ((matched & 0xaaaaaaaa) != 0xaaaaaaaa) {
+      break;
     }
+    __m256i bits = _mm256_and_si256(rounds, low_bits);
+    __m256i index =
+      _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi32(bits, 2), _mm256_srli_epi32(bits, 16)), index_mask);
+    sum_v1 = _mm256_add_epi64(sum_v1, _mm256_sad_epu8(_mm256_shuffle_epi8(table_v1, index), _mm256_setzero_si256()));
+    sum_v2 = _mm256_add_epi64(sum_v2, _mm256_sad_epu8(_mm256_shuffle_epi8(table_v2, index), _mm256_setzero_si256()));
+  }
 
-    std::printf("My total v1: %d\n", myTotal);
+  totals.v1 += horizontal_sum(_mm_add_epi64(_mm256_castsi256_si128(sum_v1), _mm256_extracti128_si256(sum_v1, 1)));
+  totals.v2 += horizontal_sum(_mm_add_epi64(_mm256_castsi256_si128(sum_v2), _mm256_extracti128_si256(sum_v2, 1)));
+  return offset;
+}
+#endif
+
+/* Widest kernel the CPU running us supports, picked once */
+[[nodiscard]] kernel_t pick_kernel() noexcept {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return score_avx2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return score_ssse3;
   }
-  {
-    std::ifstream fs("input.txt", fs.in);
+#endif
+  return score_scalar;
+}
 
-    int myTotal = 0;
-    for (Strat s; fs >> s; ) {
-      s.calculate_score_v2();
-      myTotal += s.m_your_score;
-    }
+void score_run(std::string_view lines, Totals &totals) noexcept {
+  static const kernel_t kernel = pick_kernel();
+  size_t scored = kernel(lines, totals);
+  score_lines(lines.substr(scored), totals);
+}
+
+/* Runs smaller than this are scored on the calling thread */
+constexpr size_t min_chunk_size = 1024 * 1024;
 
-    std::printf("My total v2: %d\n", myTotal);
+/*
+ * Scores the guide both ways in one pass over the file. Each window is cut
+ * at newlines, which on well formed input are the 4 byte round boundaries,
+ * into a chunk per thread of the global ExecutionContext. Every chunk is
+ * scored into its own 64 bit totals and those are summed.
+ */
+[[nodiscard]] Totals score_guide(const FileStreamer &fs) {
+  auto &context = ExecutionContext::global();
+  Totals totals;
+  fs.for_each_line_run([&](std::string_view run) {
+    auto pieces = split_lines(run, context.threads(), min_chunk_size);
+    totals = context.parallel_reduce(
+      pieces.size(), totals,
+      [&](size_t idx) {
+        Totals partial;
+        score_run(pieces[idx], partial);
+        return partial;
+      },
+      [](Totals sum, const Totals &partial) {
+        sum.v1 += partial.v1;
+        sum.v2 += partial.v2;
+        return sum;
+      });
+  });
+  return totals;
+}
+
+const RegisterSolution register_part1{{2, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  return std::to_string(score_guide(FileStreamer{input}).v1);
+}}};
+
+const RegisterSolution register_part2{{2, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  return std::to_string(score_guide(FileStreamer{input}).v2);
+}}};
+} // namespace day2
+
+#ifndef AOC_NO_MAIN
+using namespace day2;
+
+int main(void) {
+  FileStreamer fs{"input.txt"};
+  if (!fs.is_valid()) {
+    return EXIT_FAILURE;
   }
+
+  Totals totals = score_guide(fs);
+
+  std::printf("My total v1: %" PRIu64 "\n", totals.v1);
+  std::printf("My total v2: %" PRIu64 "\n", totals.v2);
   return 0;
 }
+#endif
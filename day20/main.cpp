@@ -9,6 +9,8 @@
 #include <iterator>
 #include <memory>
 
+namespace day20 {
+
 using crypto_number_t = std::int64_t;
 using crypto_entity_t = std::shared_ptr<crypto_number_t>;
 using crypto_key_t = std::vector<crypto_entity_t>;
@@ -19,9 +21,10 @@ struct SolverBase {
 
   SolverBase(const FileHelper &file_helper) {
   auto _ = TimeIt("SolverBase");
-    crypto_number_t value;
-    auto ss = file_helper.get_stringstream();
-    while (ss >> value) {
+    std::vector<crypto_number_t> values;
+    append_integers(file_helper.get_view(), values);
+    crypto_key.reserve(values.size());
+    for (auto value : values) {
       crypto_key.emplace_back(std::make_shared<crypto_number_t>(value));
     }
     std::cout << "Read all " << crypto_key.size() << " keys\n";
@@ -54,10 +57,28 @@ struct Solver2 :SolverBase {
   }
 };
 
+const RegisterSolution register_part1{{20, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver1 solver{file_helper};
+  return std::to_string(solver());
+}}};
+
+const RegisterSolution register_part2{{20, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  Solver2 solver{file_helper};
+  return std::to_string(solver());
+}}};
+} // namespace day20
+
+#ifndef AOC_NO_MAIN
+using namespace day20;
 
 int main(void) noexcept {
   {
     FileHelper file_helper{"input.txt"};
+    if (!file_helper.is_valid()) {
+      return EXIT_FAILURE;
+    }
     Solver1 s1{file_helper};
     s1();
     Solver2 s2{file_helper};
@@ -66,3 +87,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
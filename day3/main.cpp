@@ -1,14 +1,12 @@
 #include <algorithm>
 #include <bitset>
 #include <cstdio>
-#include <fcntl.h>
-#include <sstream>
-#include <sys/mman.h>
-#include <sys/stat.h>
-
-namespace {
-const char *inputMap = nullptr;
+#include <cstdlib>
+#include <string_view>
+#include <string>
+#include "utils.h"
 
+namespace day3 {
 [[nodiscard]] inline unsigned char get_char_value(char item) noexcept {
   if (item >= 'a' && item <= 'z') {
     return item - 97;
@@ -32,68 +30,76 @@ template<typename... Targs>
 }
 
 
-[[nodiscard]] unsigned int part1(auto &&ss) noexcept {
-  unsigned int total = 0;
-
-  for (std::string s; std::getline(ss, s);) {
-    auto it = std::next(s.begin(), s.length() / 2);
-
-    std::bitset<index_size> index;
-
-    std::for_each(s.begin(), it,
-                  [&index](auto c) { index.set(get_char_value(c)); });
+[[nodiscard]] inline std::bitset<index_size> get_index(std::string_view s) noexcept {
+  std::bitset<index_size> index;
+  std::for_each(s.begin(), s.end(), [&index](auto c) { index.set(get_char_value(c)); });
+  return index;
+}
 
-    std::bitset<index_size> second_index;
+[[nodiscard]] unsigned int part1(const FileStreamer &fs) noexcept {
+  auto _ = TimeIt("Part1");
+  unsigned int total = 0;
 
-    std::for_each(it, s.end(), [&second_index](auto c) {
-      second_index.set(get_char_value(c));
-    });
+  fs.for_each_line([&total](std::string_view s) {
+    auto index = get_index(s.substr(0, s.length() / 2));
+    auto second_index = get_index(s.substr(s.length() / 2));
 
     total += find_intersecting(index, second_index);
-  }
+  });
 
   return total;
 }
 
-[[nodiscard]] unsigned int part2(auto &&ss) noexcept {
+[[nodiscard]] unsigned int part2(const FileStreamer &fs) noexcept {
+  auto _ = TimeIt("Part2");
   unsigned int total = 0;
+  size_t group_member = 0;
+  std::bitset<index_size> index1;
+  std::bitset<index_size> index2;
+
+  fs.for_each_line([&](std::string_view s) {
+    switch (group_member) {
+    case 0:
+      index1 = get_index(s);
+      break;
+    case 1:
+      index2 = get_index(s);
+      break;
+    case 2:
+      total += find_intersecting(index1, index2, get_index(s));
+      break;
+    }
+    group_member = (group_member + 1) % 3;
+  });
 
-  for (std::string s1, s2, s3; ss.peek() != EOF;) {
-    std::getline(ss, s1);
-    std::bitset<index_size> index1;
-    std::for_each(s1.begin(), s1.end(),
-                  [&index1](auto c) { index1.set(get_char_value(c)); });
-
-    std::getline(ss, s2);
-    std::bitset<index_size> index2;
-    std::for_each(s2.begin(), s2.end(),
-                  [&index2](auto c) { index2.set(get_char_value(c)); });
+  return total;
+}
 
-    std::getline(ss, s3);
-    std::bitset<index_size> index3;
-    std::for_each(s3.begin(), s3.end(),
-                  [&index3](auto c) { index3.set(get_char_value(c)); });
+const RegisterSolution register_part1{{3, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileStreamer fs{input};
+  return std::to_string(part1(fs));
+}}};
 
-    total += find_intersecting(index1, index2, index3);
-  }
+const RegisterSolution register_part2{{3, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileStreamer fs{input};
+  return std::to_string(part2(fs));
+}}};
+} // namespace day3
 
-  return total;
-}
+#ifndef AOC_NO_MAIN
+using namespace day3;
 
-} // namespace
 int main(void) noexcept {
-  struct stat s;
-  int fd = open("input.txt", O_RDONLY);
-  fstat(fd, &s);
-
-  inputMap = static_cast<const char *>(
-      mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  std::istringstream iss1{std::string(inputMap, s.st_size), std::ios_base::in};
-  auto total1 = part1(iss1);
+  FileStreamer fs{"input.txt"};
+  if (!fs.is_valid()) {
+    return EXIT_FAILURE;
+  }
+
+  auto total1 = part1(fs);
   std::printf("Total1: %d\n", total1);
-  std::istringstream iss2{std::string(inputMap, s.st_size), std::ios_base::in};
-  auto total2 = part2(iss2);
+  auto total2 = part2(fs);
   std::printf("Total2: %d\n", total2);
 
   return 0;
 }
+#endif
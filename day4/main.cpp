@@ -1,15 +1,14 @@
+#include <array>
 #include <bitset>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#include <vector>
-namespace {
-const char *inputMap = nullptr;
-
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <string_view>
+#include "utils.h"
+namespace day4 {
 constexpr size_t range_length = 100;
 
 [[nodiscard]] inline std::bitset<range_length>
@@ -22,25 +21,13 @@ create_assignment(std::uint16_t start, std::uint16_t end) noexcept {
 }
 
 struct [[nodiscard]] AssRange {
-  [[nodiscard]] AssRange(const char *in, size_t len) noexcept {
-    int i = 0;
-
-    auto parseUntil = [&i, &in, len](auto &val, auto delim) {
-      for (; i < len; ++i) {
-        if (in[i] >= '0' && in[i] <= '9') {
-          val = (val * 10) + (in[i] - '0');
-          continue;
-        }
-        if (in[i] == delim) {
-          break;
-        }
-      }
-    };
-
-    parseUntil(range1_start, '-');
-    parseUntil(range1_end, ',');
-    parseUntil(range2_start, '-');
-    parseUntil(range2_end, '\n');
+  [[nodiscard]] AssRange(std::string_view line) noexcept {
+    std::array<std::uint16_t, 4> bounds{};
+    (void)parse_integers(line, std::span{bounds});
+    range1_start = bounds[0];
+    range1_end = bounds[1];
+    range2_start = bounds[2];
+    range2_end = bounds[3];
 
     assignment1 = create_assignment(range1_start, range1_end);
     assignment2 = create_assignment(range2_start, range2_end);
@@ -56,55 +43,58 @@ struct [[nodiscard]] AssRange {
   std::bitset<range_length> assignment2;
 };
 
-[[nodiscard]] std::uint16_t part1(std::vector<AssRange> asses) noexcept {
-  size_t total = 0;
-  for (auto &ass : asses) {
-    auto compare_assignment = (ass.assignment1 & ass.assignment2);
-    if (compare_assignment == ass.assignment2 ||
-        compare_assignment == ass.assignment1) {
-      ++total;
-    }
-  }
+[[nodiscard]] bool part1(const AssRange &ass) noexcept {
+  auto compare_assignment = (ass.assignment1 & ass.assignment2);
+  return compare_assignment == ass.assignment2 ||
+         compare_assignment == ass.assignment1;
+}
 
-  return total;
+[[nodiscard]] bool part2(const AssRange &ass) noexcept {
+  return (ass.assignment1 & ass.assignment2) != 0;
 }
 
-[[nodiscard]] std::uint16_t part2(std::vector<AssRange> asses) noexcept {
-  size_t total = 0;
-  for (auto &ass : asses) {
-    if ((ass.assignment1 & ass.assignment2) != 0) {
-      ++total;
-    }
-  }
+struct Totals {
+  size_t contained = 0;
+  size_t overlapping = 0;
+};
 
-  return total;
+/* Counts both parts in one pass over the file */
+[[nodiscard]] Totals count_assignments(const FileStreamer &fs) {
+  Totals totals;
+  fs.for_each_line([&](std::string_view line) {
+    if (line.empty()) {
+      return;
+    }
+    AssRange ass{line};
+    totals.contained += part1(ass);
+    totals.overlapping += part2(ass);
+  });
+  return totals;
 }
-} // namespace
+
+const RegisterSolution register_part1{{4, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  return std::to_string(count_assignments(FileStreamer{input}).contained);
+}}};
+
+const RegisterSolution register_part2{{4, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  return std::to_string(count_assignments(FileStreamer{input}).overlapping);
+}}};
+} // namespace day4
+
+#ifndef AOC_NO_MAIN
+using namespace day4;
 
 int main(void) noexcept {
-  struct stat s;
-  int fd = open("input.txt", O_RDONLY);
-  fstat(fd, &s);
-
-  inputMap = static_cast<const char *>(
-      mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-
-  std::vector<AssRange> asses;
-  size_t abspos = 0;
-  for (size_t i = 0; i < s.st_size; ++i) {
-    if (inputMap[i] == '\n') {
-      asses.emplace_back(inputMap + abspos, i - abspos);
-      abspos = i;
-    }
+  FileStreamer fs{"input.txt"};
+  if (!fs.is_valid()) {
+    return EXIT_FAILURE;
   }
 
-  auto total1 = part1(asses);
-  std::printf("Total1: %d\n", total1);
-
-  auto total2 = part2(asses);
-  std::printf("Total2: %d\n", total2);
+  Totals totals = count_assignments(fs);
 
-  close(fd);
+  std::printf("Total1: %lu\n", totals.contained);
+  std::printf("Total2: %lu\n", totals.overlapping);
 
   return 0;
 }
+#endif
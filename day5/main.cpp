@@ -1,20 +1,12 @@
 #include <algorithm>
-#include <boost/regex.hpp>
-#include <boost/regex/v5/error_type.hpp>
-#include <boost/regex/v5/match_flags.hpp>
-#include <fcntl.h>
+#include <cstdlib>
 #include <iostream>
 #include <iterator>
 #include <map>
-#include <regex>
 #include <string_view>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
 #include <vector>
-namespace {
-const char *inputMap = nullptr;
-
+#include "utils.h"
+namespace day5 {
 [[nodiscard]] auto construct_inventory(std::string_view sv) noexcept {
   std::map<char, std::vector<char>> inventory;
   std::map<char, size_t> position;
@@ -49,33 +41,34 @@ const char *inputMap = nullptr;
   return inventory;
 }
 
-void iterate_over_commands(std::string title, std::string_view sv,
-                           auto &inventory, auto callback) noexcept {
-  auto command_start = sv.find("\n\n");
-  std::string command_text(std::next(sv.begin(), command_start + 2), sv.end());
-  boost::regex command_regex("move (\\d+) from (\\d+) to (\\d+)");
+constexpr Pattern<"move {i} from {i} to {i}"> command_pattern;
 
-  boost::sregex_iterator cmd_begin(command_text.begin(), command_text.end(),
-                                   command_regex);
-  boost::sregex_iterator cmd_end;
+void iterate_over_commands(std::string_view sv, auto callback) noexcept {
+  auto command_start = sv.find("\n\n");
+  auto commands = command_pattern.scan(sv.substr(command_start + 2));
 
-  std::for_each(cmd_begin, cmd_end, callback);
+  std::for_each(commands.begin(), commands.end(), callback);
+}
 
-  std::printf("%s: ", title.c_str());
-  for (auto entity : inventory) {
-    std::printf("%c", entity.second.back());
+/* Crate on top of every stack, left to right */
+[[nodiscard]] std::string top_crates(const auto &inventory) {
+  std::string result;
+  for (const auto &entity : inventory) {
+    if (!entity.second.empty()) {
+      result.push_back(entity.second.back());
+    }
   }
-  std::printf("\n");
+  return result;
 }
 
-void part1(const char *in) noexcept {
-  std::string_view sv{in};
+[[nodiscard]] std::string part1(std::string_view sv) {
+  auto _ = TimeIt("Part1");
   auto inventory = construct_inventory(sv);
 
-  iterate_over_commands("Part1", sv, inventory, [&](const auto &what) -> bool {
-    std::uint8_t amount = std::stoi(what[1].str());
-    char from = what[2].str()[0];
-    char to = what[3].str()[0];
+  iterate_over_commands(sv, [&](const auto &what) -> bool {
+    auto amount = parse_number<std::uint8_t>(what[0]);
+    char from = what[1][0];
+    char to = what[2][0];
 
     for (int i = 0; i < amount; ++i) {
       if (!(inventory.at(from).empty())) {
@@ -86,16 +79,18 @@ void part1(const char *in) noexcept {
     }
     return true;
   });
+
+  return top_crates(inventory);
 }
 
-void part2(const char *in) noexcept {
-  std::string_view sv{in};
+[[nodiscard]] std::string part2(std::string_view sv) {
+  auto _ = TimeIt("Part2");
   auto inventory = construct_inventory(sv);
 
-  iterate_over_commands("Part2", sv, inventory, [&](const auto &what) -> bool {
-    std::uint8_t amount = std::stoi(what[1].str());
-    char from = what[2].str()[0];
-    char to = what[3].str()[0];
+  iterate_over_commands(sv, [&](const auto &what) -> bool {
+    auto amount = parse_number<std::uint8_t>(what[0]);
+    char from = what[1][0];
+    char to = what[2][0];
 
     if (!(inventory.at(from).empty())) {
       auto begin = std::prev(inventory[from].end(), amount);
@@ -106,22 +101,33 @@ void part2(const char *in) noexcept {
 
     return true;
   });
+
+  return top_crates(inventory);
 }
 
-} // namespace
+const RegisterSolution register_part1{{5, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return part1(file_helper.get_view());
+}}};
 
-int main(void) noexcept {
-  struct stat s;
-  int fd = open("input.txt", O_RDONLY);
-  fstat(fd, &s);
+const RegisterSolution register_part2{{5, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return part2(file_helper.get_view());
+}}};
+} // namespace day5
 
-  inputMap = static_cast<const char *>(
-      mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
+#ifndef AOC_NO_MAIN
+using namespace day5;
 
-  part1(inputMap);
-  part2(inputMap);
+int main(void) noexcept {
+  FileHelper file_helper{"input.txt"};
+  if (!file_helper.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
-  close(fd);
+  std::printf("Part1: %s\n", part1(file_helper.get_view()).c_str());
+  std::printf("Part2: %s\n", part2(file_helper.get_view()).c_str());
 
   return 0;
 }
+#endif
@@ -1,63 +1,69 @@
 #include <algorithm>
-#include <bitset>
+#include <array>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <string_view>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <string>
+#include "utils.h"
 
+namespace day6 {
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open("input.txt", O_RDONLY);
+/*
+ * Streams the datastream and returns the position right after the first run
+ * of data_msg_length distinct characters. last_seen holds the position after
+ * the previous occurrence of every character, so a run starts right after
+ * the latest repeat.
+ */
+[[nodiscard]] size_t subroutine(const FileStreamer &fs,
+                                size_t data_msg_length) noexcept {
+  auto _ = TimeIt("subroutine");
+  std::array<size_t, 256> last_seen{};
+  size_t run_start = 0;
+  size_t position = 0;
+  size_t result = 0;
 
-    fstat(fd, &s);
+  fs.for_each_window([&](std::string_view window) -> bool {
+    for (char c : window) {
+      auto &seen = last_seen[static_cast<unsigned char>(c)];
+      run_start = std::max(run_start, seen);
+      seen = ++position;
+      if (position - run_start == data_msg_length) {
+        result = position;
+        return false;
+      }
+    }
+    return true;
+  });
 
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
+  return result;
+}
 
-  ~FileHelper() {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-};
+const RegisterSolution register_part1{{6, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileStreamer fs{input};
+  return std::to_string(subroutine(fs, 4));
+}}};
 
-[[nodiscard]] size_t subroutine(const char *in, size_t in_length,
-                                size_t data_msg_length) noexcept {
-  std::string_view check{in, in_length};
-
-  for (size_t idx = 0; idx < check.length(); ++idx) {
-    bool failed = false;
-    auto begin = std::next(check.begin(), idx);
-    auto end = std::next(begin, data_msg_length);
-    std::for_each(begin, end, [&failed, check_bitset = std::bitset<123>()](const char &c) mutable {
-        failed |= check_bitset[c];
-        check_bitset.set(c);
-      });
-    if (!failed) {
-      return std::distance(check.begin(), end);
-    }
-  }
+const RegisterSolution register_part2{{6, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileStreamer fs{input};
+  return std::to_string(subroutine(fs, 14));
+}}};
+} // namespace day6
 
-  return 0;
-}
+#ifndef AOC_NO_MAIN
+using namespace day6;
 
 int main(void) noexcept {
-  FileHelper file_helper{"input.txt"};
+  FileStreamer fs{"input.txt"};
+  if (!fs.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
-  auto offset1 = subroutine(file_helper.input_data, file_helper.s.st_size, 4);
+  auto offset1 = subroutine(fs, 4);
   std::printf("Part1: %lu\n", offset1);
 
-  auto offset2 = subroutine(file_helper.input_data, file_helper.s.st_size, 14);
+  auto offset2 = subroutine(fs, 14);
   std::printf("Part2: %lu\n", offset2);
 
   return EXIT_SUCCESS;
 }
+#endif
@@ -1,43 +1,17 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
 #include <iomanip>
 #include <iostream>
 #include <memory>
-#include <sstream>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <string_view>
 #include <unordered_map>
+#include <string>
+#include "utils.h"
 
-constexpr size_t filesystem_size = 70000000;
-
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
+namespace day7 {
 
-  ~FileHelper() {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const {
-    return std::istringstream{std::string(input_data, s.st_size),
-                              std::ios_base::in};
-  }
-};
+constexpr size_t filesystem_size = 70000000;
 
 class ElfCrappyFileSystem
     : public std::enable_shared_from_this<ElfCrappyFileSystem> {
@@ -112,19 +86,19 @@ public:
 
   [[nodiscard]] static std::shared_ptr<ElfCrappyFileSystem>
   constuct_filesystem(const FileHelper &file_helper) {
-    std::string cmd;
-
-    auto iss = file_helper.get_stringstream();
-
+    auto _ = TimeIt("constuct_filesystem");
     auto root = ElfCrappyFileSystem::create();
     std::shared_ptr<ElfCrappyFileSystem> current{root->get_ptr()};
 
-    while (std::getline(iss, cmd)) {
+    for (std::string_view cmd : file_helper.lines()) {
+      if (cmd.empty()) {
+        continue;
+      }
       if (cmd[0] == '$') {
         if (cmd.starts_with("$ cd /")) {
           current = root;
         } else if (cmd.starts_with("$ cd ")) {
-          std::string folder_name(std::next(cmd.begin(), 5), cmd.end());
+          std::string folder_name(cmd.substr(5));
           if (folder_name == "..") {
             if (auto temp_current = current.get()->parent_ptr.lock()) {
               current = temp_current;
@@ -134,21 +108,13 @@ public:
               current = current->children[folder_name];
             }
           }
-        } else if (cmd.starts_with("$ ls")) {
-          while (iss.peek() != '$' && !iss.eof()) {
-            if (iss.peek() == 'd') {
-              std::getline(iss, cmd);
-              current->add_child(
-                  std::string(std::next(cmd.begin(), 4), cmd.end()));
-            } else {
-              size_t test;
-              std::string filename;
-              iss >> test >> filename;
-              iss.get();
-              current->add_file(filename, test);
-            }
-          }
         }
+      } else if (cmd.starts_with("dir ")) {
+        current->add_child(std::string(cmd.substr(4)));
+      } else {
+        auto separator = cmd.find(' ');
+        current->add_file(std::string(cmd.substr(separator + 1)),
+                          parse_number<size_t>(cmd.substr(0, separator)));
       }
     }
     return root;
@@ -162,6 +128,7 @@ private:
 };
 
 [[nodiscard]] size_t part1(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part1");
   auto root = ElfCrappyFileSystem::constuct_filesystem(file_helper);
 
   auto all = root->get_all_directories();
@@ -178,6 +145,7 @@ private:
 }
 
 [[nodiscard]] size_t part2(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part2");
   auto root = ElfCrappyFileSystem::constuct_filesystem(file_helper);
 
   auto all = root->get_all_directories();
@@ -197,8 +165,25 @@ private:
   return new_tot;
 }
 
+const RegisterSolution register_part1{{7, 1, "input.txt", "1582412", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper));
+}}};
+
+const RegisterSolution register_part2{{7, 2, "input.txt", "3696336", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper));
+}}};
+} // namespace day7
+
+#ifndef AOC_NO_MAIN
+using namespace day7;
+
 int main(void) noexcept {
   FileHelper file_helper{"input.txt"};
+  if (!file_helper.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
   auto result1 = part1(file_helper);
   assert(result1 == 1582412);
@@ -210,3 +195,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
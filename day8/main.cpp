@@ -1,78 +1,55 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
+#include <ranges>
 #include <string_view>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#include <sstream>
 #include <vector>
+#include <string>
+#include "utils.h"
 
-constexpr size_t filesystem_size = 70000000;
-
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
-
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
+namespace day8 {
 
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
+constexpr size_t filesystem_size = 70000000;
 
-  ~FileHelper() {
-    if (fd >= 0) {
-      close(fd);
+/* Trees looked over in order until one is at least height tall, that one included */
+template <typename Trees>
+[[nodiscard]] size_t viewing_distance(const Trees &trees, char height) noexcept {
+  size_t distance = 0;
+  for (char tree : trees) {
+    ++distance;
+    if (tree >= height) {
+      break;
     }
   }
+  return distance;
+}
 
-  [[nodiscard]] std::istringstream get_stringstream() const {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-};
+template <typename Trees>
+[[nodiscard]] bool all_lower(const Trees &trees, char height) noexcept {
+  return std::all_of(trees.begin(), trees.end(), [height](char tree) { return tree < height; });
+}
 
 class MapHeight {
 public:
-  std::vector<std::string> map;
-  MapHeight(std::vector<std::string> map_input) : map(map_input) {
+  using map_t = Grid2D<char>;
+  using index_t = map_t::index_t;
+
+  map_t map;
+  MapHeight(map_t map_input) : map(std::move(map_input)) {
   }
 
-  size_t solve_part1() {
-    size_t map_length = map.size();
-    size_t total = (map_length * 4) - 4;
-    for (int x = 1; x < map_length - 1; ++x) {
-      for (int y = 1; y < map_length - 1; ++y) {
-        auto tree_len = map[x][y];
-        bool longestx2 = true;
-        for (int x2 = 0; x2 < x; ++x2) {
-          if (map[x2][y] >= tree_len) {
-            longestx2 = false;
-          }
-        }
-        bool longestx3 = true;
-        for (int x3 = x+1; x3 < map_length; ++x3) {
-          if (map[x3][y] >= tree_len) {
-            longestx3 = false;
-          }
-        }
-        bool longesty2 = true;
-        for (int y2 = 0; y2 < y; ++y2) {
-          if (map[x][y2] >= tree_len) {
-            longesty2 = false;
-          }
-        }
-        bool longesty3 = true;
-        for (int y3 = y+1; y3 < map_length; ++y3) {
-          if (map[x][y3] >= tree_len) {
-            longesty3 = false;
-          }
-        }
-        if (longestx2 || longestx3 || longesty2 || longesty3) {
+  size_t solve_part1() const {
+    index_t width = map.width();
+    index_t height = map.height();
+    size_t total = (width * 2) + (height * 2) - 4;
+    for (index_t y = 1; y < height - 1; ++y) {
+      auto row = map.row(y);
+      for (index_t x = 1; x < width - 1; ++x) {
+        auto column = map.column(x);
+        auto tree_len = map(x, y);
+        if (all_lower(row.first(x), tree_len) || all_lower(row.subspan(x + 1), tree_len) ||
+            all_lower(column.subspan(0, y), tree_len) ||
+            all_lower(column.subspan(y + 1, height - y - 1), tree_len)) {
           ++total;
         }
       }
@@ -81,46 +58,19 @@ public:
     return total;
   }
 
-  size_t solve_part2() {
-    size_t map_length = map.size();
+  size_t solve_part2() const {
+    index_t width = map.width();
+    index_t height = map.height();
     size_t best = 0;
-    for (int x = 1; x < map_length - 1; ++x) {
-      for (int y = 1; y < map_length - 1; ++y) {
-        auto tree_len = map[x][y];
-        size_t scenic_score = 0;
-
-        size_t scenic_score_x2 = 0;
-        for (int x2 = x-1; x2 >= 0; --x2) {
-          if (map[x2][y] >= tree_len || x2 == 0) {
-            scenic_score_x2 = x - x2;
-            break;
-          }
-        }
-
-        size_t scenic_score_x3 = 0;
-        for (int x3 = x+1; x3 < map_length; ++x3) {
-          if (map[x3][y] >= tree_len || x3 == map_length - 1) {
-            scenic_score_x3 = x3 - x;
-            break;
-          }
-        }
-
-        size_t scenic_score_y2 = 0;
-        for (int y2 = y-1; y2 >= 0; --y2) {
-          if (map[x][y2] >= tree_len || y2 == 0) {
-            scenic_score_y2 = y - y2;
-            break;
-          }
-        }
-
-        size_t scenic_score_y3 = 0;
-        for (int y3= y+1; y3 < map_length; ++y3) {
-          if (map[x][y3] >= tree_len || y3 == map_length - 1) {
-            scenic_score_y3 = y3 - y;
-            break;
-          }
-        }
-        scenic_score = scenic_score_x2 * scenic_score_x3 * scenic_score_y2 * scenic_score_y3;
+    for (index_t y = 1; y < height - 1; ++y) {
+      auto row = map.row(y);
+      for (index_t x = 1; x < width - 1; ++x) {
+        auto column = map.column(x);
+        auto tree_len = map(x, y);
+        size_t scenic_score = viewing_distance(row.first(x) | std::views::reverse, tree_len) *
+                              viewing_distance(row.subspan(x + 1), tree_len) *
+                              viewing_distance(column.subspan(0, y).reversed(), tree_len) *
+                              viewing_distance(column.subspan(y + 1, height - y - 1), tree_len);
         best = std::max(best, scenic_score);
       }
     }
@@ -129,35 +79,46 @@ public:
   }
 
   [[nodiscard]] static MapHeight create_map(const FileHelper& file_helper) {
-    std::string map_slice;
-
-    auto iss = file_helper.get_stringstream();
-
-    std::vector<std::string> map_input;
-    while (std::getline(iss, map_slice)) {
-      map_input.push_back(map_slice);
-    }
-
-    return MapHeight{map_input};
+    auto _ = TimeIt("create_map");
+    return MapHeight{map_t::from_lines(file_helper.get_view())};
   }
 
 
 };
 
 [[nodiscard]] size_t part1(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part1");
   MapHeight map = MapHeight::create_map(file_helper);
 
   return map.solve_part1();
 }
 
 [[nodiscard]] size_t part2(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part2");
   MapHeight map = MapHeight::create_map(file_helper);
 
   return map.solve_part2();
 }
 
+const RegisterSolution register_part1{{8, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper));
+}}};
+
+const RegisterSolution register_part2{{8, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper));
+}}};
+} // namespace day8
+
+#ifndef AOC_NO_MAIN
+using namespace day8;
+
 int main(void) noexcept {
   FileHelper file_helper{"input.txt"};
+  if (!file_helper.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
   auto result = part1(file_helper);
   std::printf("Part1: %lu\n", result);
@@ -167,3 +128,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
@@ -1,52 +1,24 @@
 #include <algorithm>
-#include <boost/functional/hash.hpp>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <fcntl.h>
-#include <sstream>
 #include <string_view>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#include <unordered_map>
 #include <vector>
+#include <string>
+#include "utils.h"
 
-struct FileHelper {
-  const char *input_data;
-  int fd = -1;
-  struct stat s;
+namespace day9 {
 
-  [[nodiscard]] FileHelper(std::string filename) noexcept {
-    fd = open(filename.c_str(), O_RDONLY);
-
-    fstat(fd, &s);
-
-    input_data = static_cast<const char *>(
-        mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0));
-  }
-
-  ~FileHelper() noexcept {
-    if (fd >= 0) {
-      close(fd);
-    }
-  }
-
-  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
-    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
-  }
-};
-
-using point_t = std::int16_t;
+using point_t = std::int32_t;
 using coordinates_t = std::pair<point_t, point_t>;
-using visited_t = std::unordered_map<coordinates_t, bool, boost::hash<coordinates_t>>;
+using visited_t = FlatHashSet<std::uint64_t>;
 
 struct Instruction {
   char direction;
   int steps;
-  [[nodiscard]] Instruction(std::string line) noexcept {
+  [[nodiscard]] Instruction(std::string_view line) noexcept {
     direction = line[0];
-    steps = std::stoi(line.substr(2));
+    steps = parse_number<int>(line.substr(2));
   }
 };
 
@@ -70,7 +42,7 @@ public:
       tails[0].second = head.second - ((instruction.direction == 'R' ? 1 : 0) + (instruction.direction == 'L' ? -1 : 0));
     }
     update_rest_of_tail();
-    visited[tails.back()] = true;
+    visited.insert(pack_2d(tails.back().first, tails.back().second));
   }
 
   [[nodiscard]] bool need_to_step(const coordinates_t& target, const coordinates_t& tail) const noexcept {
@@ -109,7 +81,7 @@ public:
   }
 
   [[nodiscard]] size_t solve() noexcept {
-    visited[coordinates_t{0,0}] = true;
+    visited.insert(pack_2d(0, 0));
     for (auto v : cmds) {
       for (size_t i = 0; static_cast<point_t>(i) < v.steps; ++i) {
         step_head(v);
@@ -147,12 +119,9 @@ public:
   }
 
   [[nodiscard]] static Rope create_command_map(const FileHelper& file_helper, size_t tail_size) noexcept {
-    std::string cmd;
-
-    auto iss = file_helper.get_stringstream();
-
+    auto _ = TimeIt("create_command_map");
     std::vector<Instruction> cmd_input;
-    while (std::getline(iss, cmd)) {
+    for (std::string_view cmd : file_helper.lines()) {
       cmd_input.emplace_back(cmd);
     }
 
@@ -163,20 +132,39 @@ public:
 };
 
 [[nodiscard]] size_t part1(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part1");
   Rope commands = Rope::create_command_map(file_helper, 1);
 
   return commands.solve();
 }
 
 [[nodiscard]] size_t part2(const FileHelper &file_helper) noexcept {
+  auto _ = TimeIt("Part2");
   Rope commands = Rope::create_command_map(file_helper, 9);
 
   return commands.solve();
 }
 
+const RegisterSolution register_part1{{9, 1, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part1(file_helper));
+}}};
+
+const RegisterSolution register_part2{{9, 2, "input.txt", "", [](const std::string &input) -> std::string {
+  FileHelper file_helper{input};
+  return std::to_string(part2(file_helper));
+}}};
+} // namespace day9
+
+#ifndef AOC_NO_MAIN
+using namespace day9;
+
 int main(void) noexcept {
   {
   FileHelper file_helper{"input.txt"};
+  if (!file_helper.is_valid()) {
+    return EXIT_FAILURE;
+  }
 
   auto result = part1(file_helper);
   std::printf("Part1: %lu\n", result);
@@ -187,3 +175,4 @@ int main(void) noexcept {
 
   return EXIT_SUCCESS;
 }
+#endif
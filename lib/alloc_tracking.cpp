@@ -0,0 +1,148 @@
+#include "alloc_tracking.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+/*
+ * Replaces every global operator new and delete. Each forwards to malloc or
+ * aligned_alloc and updates the calling thread's counters, which are plain
+ * thread_local integers so the bookkeeping itself never allocates.
+ */
+
+namespace {
+thread_local AllocCounters counters;
+
+void record_allocation(void *ptr) noexcept {
+  auto size = static_cast<std::int64_t>(malloc_usable_size(ptr));
+  ++counters.allocations;
+  counters.bytes += static_cast<std::uint64_t>(size);
+  counters.live_bytes += size;
+  if (counters.live_bytes > counters.peak_live_bytes) {
+    counters.peak_live_bytes = counters.live_bytes;
+  }
+}
+
+[[nodiscard]] void *allocate(std::size_t size, std::size_t alignment) noexcept {
+  size = size == 0 ? 1 : size;
+  void *ptr = nullptr;
+  if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    ptr = std::malloc(size);
+  } else {
+    /* aligned_alloc wants the size to be a multiple of the alignment */
+    ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  }
+  if (ptr != nullptr) {
+    record_allocation(ptr);
+  }
+  return ptr;
+}
+
+[[nodiscard]] void *allocate_or_throw(std::size_t size, std::size_t alignment) {
+  while (true) {
+    if (void *ptr = allocate(size, alignment)) {
+      return ptr;
+    }
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void release(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  counters.live_bytes -= static_cast<std::int64_t>(malloc_usable_size(ptr));
+  std::free(ptr);
+}
+
+constexpr std::size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+} // namespace
+
+AllocCounters &thread_alloc_counters() noexcept {
+  return counters;
+}
+
+void *operator new(std::size_t size) {
+  return allocate_or_throw(size, default_alignment);
+}
+
+void *operator new[](std::size_t size) {
+  return allocate_or_throw(size, default_alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, default_alignment);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, default_alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  release(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+  release(ptr);
+}
@@ -0,0 +1,26 @@
+#ifndef ALLOC_TRACKING_H_N4DQ8WZE
+#define ALLOC_TRACKING_H_N4DQ8WZE
+
+#include <cstdint>
+
+/*
+ * Heap use of one thread as seen by the global operator new/delete
+ * replacements in alloc_tracking.cpp. Those are only compiled in with the
+ * AOC_ALLOC_TRACKING CMake option, TimeIt then charges the difference
+ * between entering and leaving a scope to that scope.
+ *
+ * Sizes are malloc_usable_size(), so they include allocator rounding. Memory
+ * freed on another thread than it was allocated on lowers that thread's
+ * live bytes, which can then go negative.
+ */
+struct AllocCounters {
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;
+  std::int64_t live_bytes = 0;
+  /* high water mark of live_bytes, TimeIt lowers it to the current value on entry */
+  std::int64_t peak_live_bytes = 0;
+};
+
+[[nodiscard]] AllocCounters &thread_alloc_counters() noexcept;
+
+#endif /* end of include guard: ALLOC_TRACKING_H_N4DQ8WZE */
@@ -0,0 +1,136 @@
+#include "execution_context.h"
+
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "time_it.h"
+
+namespace {
+std::optional<ExecutionSettings> &global_settings() {
+  static std::optional<ExecutionSettings> settings;
+  return settings;
+}
+
+[[nodiscard]] size_t available_cpus() noexcept {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    return static_cast<size_t>(std::max(1, CPU_COUNT(&set)));
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void pin_to_cpu(int cpu) noexcept {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  static std::atomic_flag warned = ATOMIC_FLAG_INIT;
+  if (error != 0 && !warned.test_and_set()) {
+    std::fprintf(stderr, "could not pin worker to cpu %d (%s), running unpinned\n", cpu, std::strerror(error));
+  }
+}
+
+[[nodiscard]] bool parse_cpu(std::string_view text, int &cpu) noexcept {
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+  return error == std::errc{} && end == text.data() + text.size() && cpu >= 0 && cpu < CPU_SETSIZE;
+}
+} // namespace
+
+bool parse_cpu_list(std::string_view text, std::vector<int> &cpus) {
+  std::vector<int> parsed;
+  while (!text.empty()) {
+    auto comma = text.find(',');
+    std::string_view range = text.substr(0, comma);
+    text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+
+    auto dash = range.find('-');
+    int first = 0;
+    int last = 0;
+    if (!parse_cpu(range.substr(0, dash), first) ||
+        !parse_cpu(dash == std::string_view::npos ? range : range.substr(dash + 1), last) || last < first) {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      parsed.push_back(cpu);
+    }
+  }
+  if (parsed.empty()) {
+    return false;
+  }
+  cpus = std::move(parsed);
+  return true;
+}
+
+ExecutionSettings ExecutionSettings::from_env() {
+  ExecutionSettings settings;
+  if (const char *env = std::getenv("AOC_AFFINITY"); env != nullptr && *env != '\0') {
+    if (!parse_cpu_list(env, settings.cpus)) {
+      std::fprintf(stderr, "AOC_AFFINITY=%s is not a cpu list like 0-3,8, ignored\n", env);
+    }
+  }
+  settings.threads = settings.cpus.empty() ? available_cpus() : settings.cpus.size();
+  if (const char *env = std::getenv("AOC_THREADS"); env != nullptr && *env != '\0') {
+    size_t threads = std::strtoul(env, nullptr, 10);
+    if (threads > 0) {
+      settings.threads = threads;
+    } else {
+      std::fprintf(stderr, "AOC_THREADS=%s is not a thread count, ignored\n", env);
+    }
+  }
+  if (const char *env = std::getenv("AOC_DETERMINISTIC"); env != nullptr) {
+    settings.deterministic = *env != '\0' && std::strcmp(env, "0") != 0;
+  }
+  return settings;
+}
+
+ExecutionContext::ExecutionContext(ExecutionSettings settings) : execution_settings(std::move(settings)) {
+  execution_settings.threads = std::max<size_t>(1, execution_settings.threads);
+}
+
+ExecutionContext &ExecutionContext::global() {
+  static ExecutionContext context{global_settings() ? *global_settings() : ExecutionSettings::from_env()};
+  return context;
+}
+
+void ExecutionContext::configure_global(ExecutionSettings settings) {
+  global_settings() = std::move(settings);
+}
+
+ThreadPool &ExecutionContext::pool() {
+  std::call_once(pool_started, [this] {
+    ThreadPool::worker_start_t on_start;
+    if (!execution_settings.cpus.empty()) {
+      on_start = [cpus = execution_settings.cpus](size_t index) { pin_to_cpu(cpus[index % cpus.size()]); };
+    }
+    worker_pool = std::make_unique<ThreadPool>(execution_settings.threads, !execution_settings.deterministic,
+                                               std::move(on_start));
+  });
+  return *worker_pool;
+}
+
+std::vector<std::uint64_t> ExecutionContext::busy_ns() const {
+  return worker_pool ? worker_pool->busy_ns() : std::vector<std::uint64_t>{};
+}
+
+void ExecutionContext::print_busy_time(std::FILE *out, std::uint64_t wall_ns) const {
+  auto busy = busy_ns();
+  for (size_t worker = 0; worker < busy.size(); ++worker) {
+    std::fprintf(out, "worker %zu", worker);
+    if (!execution_settings.cpus.empty()) {
+      std::fprintf(out, " (cpu %d)", execution_settings.cpus[worker % execution_settings.cpus.size()]);
+    }
+    std::fprintf(out, ": busy %s", format_duration(busy[worker]).c_str());
+    if (wall_ns > 0) {
+      std::fprintf(out, ", %.1f%%", 100.0 * static_cast<double>(busy[worker]) / static_cast<double>(wall_ns));
+    }
+    std::fprintf(out, "\n");
+  }
+}
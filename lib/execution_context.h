@@ -0,0 +1,168 @@
+#ifndef EXECUTION_CONTEXT_H_H3ZK8WQD
+#define EXECUTION_CONTEXT_H_H3ZK8WQD
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+struct ExecutionSettings {
+  /* Worker threads, 1 runs everything on the calling thread */
+  size_t threads = 1;
+  /* CPUs the workers are pinned to, round robin, empty leaves them unpinned */
+  std::vector<int> cpus;
+  /*
+   * Static scheduling without work stealing, and reductions split and
+   * combined in the same order whatever the thread count, so every run
+   * does the same work in the same order.
+   */
+  bool deterministic = false;
+
+  /*
+   * Defaults overridden by AOC_THREADS=N, AOC_AFFINITY=LIST and
+   * AOC_DETERMINISTIC=1. Without AOC_THREADS there is one thread per CPU
+   * in the affinity list, or per CPU the process may run on.
+   */
+  [[nodiscard]] static ExecutionSettings from_env();
+};
+
+/* CPU list as taskset and cgroups write it, "0-3,8,10-11" */
+[[nodiscard]] bool parse_cpu_list(std::string_view text, std::vector<int> &cpus);
+
+/*
+ * Where every parallel loop in the tree runs. Owns the ThreadPool, started
+ * on first use with the settings above. Loops started from one of its own
+ * workers run serially on that worker, so a day solved on a pool worker by
+ * aoc_all does not try to spread out over a pool that is already busy.
+ */
+class ExecutionContext {
+public:
+  explicit ExecutionContext(ExecutionSettings settings);
+
+  ExecutionContext(const ExecutionContext &) = delete;
+  ExecutionContext &operator=(const ExecutionContext &) = delete;
+
+  /* The context of the process, from the environment unless configure_global() came first */
+  [[nodiscard]] static ExecutionContext &global();
+
+  /* Settings for global(), only has an effect before its first call */
+  static void configure_global(ExecutionSettings settings);
+
+  [[nodiscard]] const ExecutionSettings &settings() const noexcept { return execution_settings; }
+  [[nodiscard]] size_t threads() const noexcept { return execution_settings.threads; }
+  [[nodiscard]] bool deterministic() const noexcept { return execution_settings.deterministic; }
+
+  [[nodiscard]] ThreadPool &pool();
+
+  /* Time each worker has spent running tasks, empty while the pool has not started */
+  [[nodiscard]] std::vector<std::uint64_t> busy_ns() const;
+
+  /* One line per worker with its busy time and share of wall_ns */
+  void print_busy_time(std::FILE *out, std::uint64_t wall_ns) const;
+
+  /* fn(begin, end) over chunks of [0, count), returns once all are done */
+  template <typename Fn>
+  void parallel_for(size_t count, Fn &&fn) {
+    if (count == 0) {
+      return;
+    }
+    if (runs_serially()) {
+      fn(size_t{0}, count);
+      return;
+    }
+    size_t chunks = chunk_count(count);
+    std::latch done{static_cast<std::ptrdiff_t>(chunks)};
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+      pool().submit([&, chunk] {
+        auto [begin, end] = chunk_range(count, chunks, chunk);
+        fn(begin, end);
+        done.count_down();
+      });
+    }
+    done.wait();
+  }
+
+  /*
+   * combine() over map(index) for every index of [0, count), starting from
+   * init. Each chunk is reduced in index order; the chunks are combined in
+   * chunk order when deterministic, and as they finish otherwise.
+   */
+  template <typename T, typename Map, typename Combine>
+  [[nodiscard]] T parallel_reduce(size_t count, T init, Map &&map, Combine &&combine) {
+    auto reduce_range = [&](size_t begin, size_t end) {
+      std::optional<T> partial;
+      for (size_t index = begin; index < end; ++index) {
+        partial = partial ? combine(std::move(*partial), map(index)) : T(map(index));
+      }
+      return partial;
+    };
+
+    size_t chunks = chunk_count(count);
+    std::vector<std::optional<T>> partials(chunks);
+    T result = std::move(init);
+
+    if (runs_serially()) {
+      for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        auto [begin, end] = chunk_range(count, chunks, chunk);
+        partials[chunk] = reduce_range(begin, end);
+      }
+    } else {
+      std::mutex result_mutex;
+      std::latch done{static_cast<std::ptrdiff_t>(chunks)};
+      for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        pool().submit([&, chunk] {
+          auto [begin, end] = chunk_range(count, chunks, chunk);
+          auto partial = reduce_range(begin, end);
+          if (!deterministic() && partial) {
+            std::lock_guard lock(result_mutex);
+            result = combine(std::move(result), std::move(*partial));
+          } else {
+            partials[chunk] = std::move(partial);
+          }
+          done.count_down();
+        });
+      }
+      done.wait();
+    }
+
+    for (auto &partial : partials) {
+      if (partial) {
+        result = combine(std::move(result), std::move(*partial));
+      }
+    }
+    return result;
+  }
+
+private:
+  /* Chunks per loop in deterministic mode, fixed so the split never depends on the thread count */
+  static constexpr size_t deterministic_chunks = 64;
+  /* Chunks per thread otherwise, a few each so a slow one can be balanced out */
+  static constexpr size_t chunks_per_thread = 4;
+
+  [[nodiscard]] bool runs_serially() { return threads() <= 1 || pool().is_worker(); }
+
+  [[nodiscard]] size_t chunk_count(size_t count) {
+    if (deterministic()) {
+      return std::min(count, deterministic_chunks);
+    }
+    return runs_serially() ? 1 : std::min(count, threads() * chunks_per_thread);
+  }
+
+  [[nodiscard]] static std::pair<size_t, size_t> chunk_range(size_t count, size_t chunks, size_t chunk) noexcept {
+    return {count * chunk / chunks, count * (chunk + 1) / chunks};
+  }
+
+  ExecutionSettings execution_settings;
+  std::once_flag pool_started;
+  std::unique_ptr<ThreadPool> worker_pool;
+};
+
+#endif /* end of include guard: EXECUTION_CONTEXT_H_H3ZK8WQD */
@@ -0,0 +1,78 @@
+#include "file_helper.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+int open_input(const std::string &filename, struct stat &s) noexcept {
+  s = {};
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::perror(filename.c_str());
+    return -1;
+  }
+
+  if (fstat(fd, &s) != 0) {
+    std::perror(filename.c_str());
+    close(fd);
+    s = {};
+    return -1;
+  }
+
+  return fd;
+}
+
+std::vector<std::string_view> split_lines(std::string_view lines, size_t count, size_t min_size) {
+  count = std::clamp<size_t>(lines.size() / std::max<size_t>(min_size, 1), 1, std::max<size_t>(count, 1));
+  std::vector<std::string_view> pieces;
+  size_t begin = 0;
+  for (size_t idx = 1; idx <= count && begin < lines.size(); ++idx) {
+    size_t end = lines.size();
+    if (idx < count) {
+      auto newline = lines.find('\n', std::max(begin, lines.size() * idx / count));
+      end = newline == std::string_view::npos ? lines.size() : newline + 1;
+    }
+    pieces.push_back(lines.substr(begin, end - begin));
+    begin = end;
+  }
+  return pieces;
+}
+
+FileHelper::FileHelper(std::string filename) noexcept {
+  fd = open_input(filename, s);
+  if (fd < 0 || s.st_size == 0) {
+    return;
+  }
+
+  void *data = mmap(nullptr, s.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    std::perror(filename.c_str());
+    close(fd);
+    fd = -1;
+    s = {};
+    return;
+  }
+
+  input_data = static_cast<const char *>(data);
+  mapped = true;
+}
+
+FileHelper::~FileHelper() noexcept {
+  if (mapped) {
+    munmap(const_cast<char *>(input_data), s.st_size);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+FileStreamer::FileStreamer(std::string filename, size_t window) noexcept {
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  window_size = std::max(page_size, window - (window % page_size));
+  fd = open_input(filename, s);
+}
+
+FileStreamer::~FileStreamer() noexcept {
+  if (fd >= 0) {
+    close(fd);
+  }
+}
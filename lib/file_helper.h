@@ -0,0 +1,179 @@
+#ifndef FILE_HELPER_H_N4TZC8WE
+#define FILE_HELPER_H_N4TZC8WE
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "parsing.h"
+
+/*
+ * Opens filename for reading and fills in s, reports failures on stderr and
+ * returns -1.
+ */
+[[nodiscard]] int open_input(const std::string &filename, struct stat &s) noexcept;
+
+/*
+ * lines cut into at most count pieces of about the same size, each at least
+ * min_size bytes unless lines is shorter. Cuts fall just after a newline,
+ * so every piece is whole lines that can be parsed on its own.
+ */
+[[nodiscard]] std::vector<std::string_view> split_lines(std::string_view lines, size_t count, size_t min_size);
+
+struct FileHelper {
+  const char *input_data = "";
+  int fd = -1;
+  struct stat s;
+  bool mapped = false;
+
+  [[nodiscard]] FileHelper(std::string filename) noexcept;
+
+  FileHelper(const FileHelper &) = delete;
+  FileHelper &operator=(const FileHelper &) = delete;
+
+  ~FileHelper() noexcept;
+
+  [[nodiscard]] bool is_valid() const noexcept {
+    return fd >= 0;
+  }
+
+  [[nodiscard]] std::string_view get_view() const noexcept {
+    return std::string_view(input_data, s.st_size);
+  }
+
+  /*
+   * Starts readahead of the whole mapping without waiting for it, so the
+   * pages are in the page cache by the time they are touched.
+   */
+  void will_need() const noexcept {
+    if (mapped) {
+      madvise(const_cast<char *>(input_data), s.st_size, MADV_WILLNEED);
+    }
+  }
+
+  [[nodiscard]] LineRange lines() const noexcept {
+    return LineRange{get_view()};
+  }
+
+  [[nodiscard]] std::istringstream get_stringstream() const noexcept {
+    return std::istringstream{std::string(input_data, s.st_size), std::ios_base::in};
+  }
+
+  [[nodiscard]] std::string get_string() const noexcept {
+    return std::string(input_data, s.st_size);
+  }
+};
+
+/*
+ * Streaming counterpart to FileHelper for inputs that do not fit in memory.
+ * Only one window of window_size bytes is mapped at a time, so the resident
+ * set stays flat no matter how large the file is.
+ */
+struct FileStreamer {
+  static constexpr size_t default_window_size = 64 * 1024 * 1024;
+
+  int fd = -1;
+  struct stat s;
+  size_t window_size;
+
+  [[nodiscard]] FileStreamer(std::string filename, size_t window = default_window_size) noexcept;
+
+  FileStreamer(const FileStreamer &) = delete;
+  FileStreamer &operator=(const FileStreamer &) = delete;
+
+  ~FileStreamer() noexcept;
+
+  [[nodiscard]] bool is_valid() const noexcept {
+    return fd >= 0;
+  }
+
+  /*
+   * Calls callback with every window of the file in order, returns false if
+   * a window could not be mapped. A callback returning bool can stop the scan
+   * early by returning false.
+   */
+  template <typename Callback>
+  bool for_each_window(Callback &&callback) const noexcept {
+    size_t file_size = static_cast<size_t>(s.st_size);
+    for (size_t offset = 0; offset < file_size; offset += window_size) {
+      size_t length = std::min(window_size, file_size - offset);
+      void *data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(offset));
+      if (data == MAP_FAILED) {
+        std::perror("mmap");
+        return false;
+      }
+      madvise(data, length, MADV_SEQUENTIAL);
+
+      std::string_view window(static_cast<const char *>(data), length);
+      bool keep_going = true;
+      if constexpr (std::is_same_v<std::invoke_result_t<Callback, std::string_view>, bool>) {
+        keep_going = callback(window);
+      } else {
+        callback(window);
+      }
+
+      munmap(data, length);
+      if (!keep_going) {
+        break;
+      }
+    }
+    return true;
+  }
+
+  /*
+   * Calls callback with the file as runs of whole lines, in order. Every run
+   * ends in a newline except possibly the last one of the file, so runs can
+   * be cut at any newline and the pieces parsed on their own. Lines that
+   * cross a window boundary are stitched together in a carry buffer and
+   * handed over as a run of their own, every other run points straight into
+   * the mapped window and is only valid during the call.
+   */
+  template <typename Callback>
+  bool for_each_line_run(Callback &&callback) const noexcept {
+    std::string carry;
+    bool ok = for_each_window([&carry, &callback](std::string_view window) {
+      if (!carry.empty()) {
+        auto newline = window.find('\n');
+        if (newline == std::string_view::npos) {
+          carry.append(window);
+          return;
+        }
+        carry.append(window.substr(0, newline + 1));
+        callback(std::string_view(carry));
+        carry.clear();
+        window.remove_prefix(newline + 1);
+      }
+
+      auto last_newline = window.rfind('\n');
+      if (last_newline == std::string_view::npos) {
+        carry.append(window);
+        return;
+      }
+
+      callback(window.substr(0, last_newline + 1));
+      carry.append(window.substr(last_newline + 1));
+    });
+
+    if (!carry.empty()) {
+      callback(std::string_view(carry));
+    }
+    return ok;
+  }
+
+  /* Calls callback with every line of the file, see for_each_line_run() */
+  template <typename Callback>
+  bool for_each_line(Callback &&callback) const noexcept {
+    return for_each_line_run([&callback](std::string_view run) {
+      for (std::string_view line : LineRange{run}) {
+        callback(line);
+      }
+    });
+  }
+};
+
+#endif /* end of include guard: FILE_HELPER_H_N4TZC8WE */
@@ -0,0 +1,283 @@
+#ifndef FLAT_HASH_H_R6NVK3PA
+#define FLAT_HASH_H_R6NVK3PA
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Coordinates packed into one 64-bit key. Two axes take 32 bits each, three
+ * take 21 bits each biased by 2^20, so any coordinate from -2^20 to
+ * 2^20 - 1 packs without collisions.
+ */
+[[nodiscard]] constexpr std::uint64_t pack_2d(std::int32_t x, std::int32_t y) noexcept {
+  return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+[[nodiscard]] constexpr std::uint64_t pack_3d(std::int32_t x, std::int32_t y, std::int32_t z) noexcept {
+  constexpr std::int64_t bias = std::int64_t{1} << 20;
+  constexpr std::uint64_t mask = (std::uint64_t{1} << 21) - 1;
+  return ((static_cast<std::uint64_t>(x + bias) & mask) << 42) | ((static_cast<std::uint64_t>(y + bias) & mask) << 21) |
+         (static_cast<std::uint64_t>(z + bias) & mask);
+}
+
+namespace flat_hash_detail {
+constexpr size_t group_size = 16;
+constexpr std::uint8_t empty = 0x80;
+
+/* Spreads every key bit over the whole word, packed keys differ in few bits */
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t key) noexcept {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+/* Bit i set when control byte i of the group equals tag, and when it is empty */
+struct GroupMatch {
+  unsigned tag;
+  unsigned empty;
+};
+
+[[nodiscard]] inline GroupMatch match_group(const std::uint8_t *group, std::uint8_t tag) noexcept {
+#if defined(__SSE2__)
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  auto tags = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(tag)))));
+  /* Only the empty marker has its high bit set */
+  auto empties = static_cast<unsigned>(_mm_movemask_epi8(bytes));
+  return {tags, empties};
+#else
+  GroupMatch match{0, 0};
+  for (unsigned idx = 0; idx < group_size; ++idx) {
+    match.tag |= static_cast<unsigned>(group[idx] == tag) << idx;
+    match.empty |= static_cast<unsigned>(group[idx] == empty) << idx;
+  }
+  return match;
+#endif
+}
+} // namespace flat_hash_detail
+
+/*
+ * Open addressing hash table for integer keys, such as the packed
+ * coordinates above. Slots are split into groups of sixteen, each with a
+ * control byte per slot holding either an empty marker or seven bits of the
+ * key's hash. A lookup compares a whole group of control bytes at once (SSE2
+ * where available) and only looks at the keys whose bits matched, moving on
+ * to the next group while the current one is full.
+ *
+ * Keys and values sit in flat arrays, so nothing is allocated per element.
+ * There is no erase: the puzzles only ever add to their sets, and without
+ * tombstones a lookup can stop at the first group with an empty slot.
+ *
+ * FlatHashSet is the same table with Value = void.
+ */
+template <std::unsigned_integral Key, typename Value>
+class FlatHashTable {
+  static constexpr bool is_set = std::is_void_v<Value>;
+  using stored_t = std::conditional_t<is_set, char, Value>;
+
+public:
+  using key_type = Key;
+  using mapped_type = Value;
+
+  FlatHashTable() = default;
+  explicit FlatHashTable(size_t expected) { reserve(expected); }
+
+  [[nodiscard]] size_t size() const noexcept { return count; }
+  [[nodiscard]] bool empty() const noexcept { return count == 0; }
+  [[nodiscard]] size_t capacity() const noexcept { return keys.size(); }
+
+  /* Room for expected elements without growing, at most 7/8 full */
+  void reserve(size_t expected) {
+    size_t needed = std::bit_ceil(std::max(expected + expected / 7 + 1, flat_hash_detail::group_size));
+    if (needed > capacity()) {
+      rehash(needed);
+    }
+  }
+
+  void clear() noexcept {
+    std::fill(control.begin(), control.end(), flat_hash_detail::empty);
+    count = 0;
+  }
+
+  [[nodiscard]] bool contains(Key key) const noexcept { return find_slot(key) != npos; }
+
+  /* Adds key, returns false when it was already there */
+  bool insert(Key key) requires is_set {
+    return insert_slot(key).second;
+  }
+
+  /*
+   * Adds every key of the range, growing once up front. The hashes of the
+   * next few keys are worked out ahead so their groups are already being
+   * fetched when their turn comes.
+   */
+  template <std::input_iterator Iterator>
+  void insert(Iterator first, Iterator last) requires is_set {
+    if constexpr (std::forward_iterator<Iterator>) {
+      reserve(count + static_cast<size_t>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      if constexpr (std::random_access_iterator<Iterator>) {
+        if (last - first > 8) {
+          prefetch(static_cast<Key>(first[8]));
+        }
+      }
+      insert_slot(static_cast<Key>(*first));
+    }
+  }
+
+  /* Adds key with value unless it is already there, the bool says which */
+  std::pair<stored_t *, bool> try_emplace(Key key, const stored_t &value) requires(!is_set) {
+    auto [slot, inserted] = insert_slot(key);
+    if (inserted) {
+      values[slot] = value;
+    }
+    return {&values[slot], inserted};
+  }
+
+  /* The value for key, default constructed if it was missing */
+  stored_t &operator[](Key key) requires(!is_set) {
+    auto [slot, inserted] = insert_slot(key);
+    if (inserted) {
+      values[slot] = stored_t{};
+    }
+    return values[slot];
+  }
+
+  /* Pointer to the value for key, nullptr when missing */
+  [[nodiscard]] stored_t *find(Key key) noexcept requires(!is_set) {
+    size_t slot = find_slot(key);
+    return slot == npos ? nullptr : &values[slot];
+  }
+  [[nodiscard]] const stored_t *find(Key key) const noexcept requires(!is_set) {
+    size_t slot = find_slot(key);
+    return slot == npos ? nullptr : &values[slot];
+  }
+
+  /* Calls fn(key) for a set or fn(key, value) for a map, in no particular order */
+  template <typename Fn>
+  void for_each(Fn &&fn) const {
+    for (size_t slot = 0; slot < capacity(); ++slot) {
+      if (control[slot] != flat_hash_detail::empty) {
+        if constexpr (is_set) {
+          fn(keys[slot]);
+        } else {
+          fn(keys[slot], values[slot]);
+        }
+      }
+    }
+  }
+
+private:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  [[nodiscard]] size_t mask() const noexcept { return capacity() - 1; }
+
+  /* Low seven bits go in the control byte, the rest pick the first group */
+  [[nodiscard]] size_t first_group(std::uint64_t hash) const noexcept {
+    return static_cast<size_t>(hash >> 7) & mask() & ~(flat_hash_detail::group_size - 1);
+  }
+
+  [[nodiscard]] static std::uint8_t tag(std::uint64_t hash) noexcept { return static_cast<std::uint8_t>(hash & 0x7F); }
+
+  void prefetch(Key key) const noexcept {
+#if defined(__GNUC__)
+    if (!keys.empty()) {
+      __builtin_prefetch(control.data() + first_group(flat_hash_detail::mix(key)));
+    }
+#endif
+  }
+
+  [[nodiscard]] size_t find_slot(Key key) const noexcept {
+    if (keys.empty()) {
+      return npos;
+    }
+    std::uint64_t hash = flat_hash_detail::mix(key);
+    for (size_t group = first_group(hash);; group = (group + flat_hash_detail::group_size) & mask()) {
+      auto match = flat_hash_detail::match_group(control.data() + group, tag(hash));
+      for (unsigned bits = match.tag; bits != 0; bits &= bits - 1) {
+        size_t slot = group + static_cast<size_t>(std::countr_zero(bits));
+        if (keys[slot] == key) {
+          return slot;
+        }
+      }
+      if (match.empty != 0) {
+        return npos;
+      }
+    }
+  }
+
+  /* Slot holding key, the bool is true when it had to be added */
+  std::pair<size_t, bool> insert_slot(Key key) {
+    if ((count + 1) * 8 > capacity() * 7) {
+      rehash(std::max(capacity() * 2, flat_hash_detail::group_size));
+    }
+    std::uint64_t hash = flat_hash_detail::mix(key);
+    for (size_t group = first_group(hash);; group = (group + flat_hash_detail::group_size) & mask()) {
+      auto match = flat_hash_detail::match_group(control.data() + group, tag(hash));
+      for (unsigned bits = match.tag; bits != 0; bits &= bits - 1) {
+        size_t slot = group + static_cast<size_t>(std::countr_zero(bits));
+        if (keys[slot] == key) {
+          return {slot, false};
+        }
+      }
+      if (match.empty != 0) {
+        size_t slot = group + static_cast<size_t>(std::countr_zero(match.empty));
+        control[slot] = tag(hash);
+        keys[slot] = key;
+        ++count;
+        return {slot, true};
+      }
+    }
+  }
+
+  void rehash(size_t new_capacity) {
+    assert(std::has_single_bit(new_capacity) && new_capacity >= flat_hash_detail::group_size);
+    auto old_control = std::move(control);
+    auto old_keys = std::move(keys);
+    auto old_values = std::move(values);
+
+    control.assign(new_capacity, flat_hash_detail::empty);
+    keys.assign(new_capacity, Key{});
+    if constexpr (!is_set) {
+      values.assign(new_capacity, stored_t{});
+    }
+    count = 0;
+
+    for (size_t slot = 0; slot < old_keys.size(); ++slot) {
+      if (old_control[slot] != flat_hash_detail::empty) {
+        size_t moved = insert_slot(old_keys[slot]).first;
+        if constexpr (!is_set) {
+          values[moved] = std::move(old_values[slot]);
+        }
+      }
+    }
+  }
+
+  std::vector<std::uint8_t> control;
+  std::vector<Key> keys;
+  std::vector<stored_t> values;
+  size_t count = 0;
+};
+
+template <std::unsigned_integral Key, typename Value>
+using FlatHashMap = FlatHashTable<Key, Value>;
+
+template <std::unsigned_integral Key>
+using FlatHashSet = FlatHashTable<Key, void>;
+
+#endif /* end of include guard: FLAT_HASH_H_R6NVK3PA */
@@ -0,0 +1,237 @@
+#ifndef GRAPH_SEARCH_H_M5QW2HZD
+#define GRAPH_SEARCH_H_M5QW2HZD
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/*
+ * Priority queue for small integer keys that never go below the last key
+ * popped, as in Dijkstra and A* with a consistent heuristic. Keys live in a
+ * ring of buckets one key wide, so push and pop are O(1) amortised; the ring
+ * doubles when a key lands further ahead than it reaches.
+ */
+template <std::unsigned_integral Key, typename Value>
+class BucketQueue {
+public:
+  BucketQueue() : buckets(16) {}
+
+  [[nodiscard]] bool empty() const noexcept { return count == 0; }
+  [[nodiscard]] size_t size() const noexcept { return count; }
+
+  void push(Key key, Value value) {
+    assert(key >= current);
+    if (key - current >= buckets.size()) {
+      grow(static_cast<size_t>(key - current) + 1);
+    }
+    buckets[key & mask()].push_back(value);
+    ++count;
+  }
+
+  /* The entry with the lowest key, the latest pushed among equal keys */
+  [[nodiscard]] std::pair<Key, Value> pop() {
+    assert(!empty());
+    while (buckets[current & mask()].empty()) {
+      ++current;
+    }
+    auto &bucket = buckets[current & mask()];
+    Value value = bucket.back();
+    bucket.pop_back();
+    --count;
+    return {current, value};
+  }
+
+  void clear() {
+    for (auto &bucket : buckets) {
+      bucket.clear();
+    }
+    current = 0;
+    count = 0;
+  }
+
+private:
+  [[nodiscard]] size_t mask() const noexcept { return buckets.size() - 1; }
+
+  void grow(size_t reach) {
+    std::vector<std::vector<Value>> grown(std::bit_ceil(std::max(reach, buckets.size() * 2)));
+    for (size_t offset = 0; offset < buckets.size(); ++offset) {
+      Key key = current + static_cast<Key>(offset);
+      grown[key & (grown.size() - 1)] = std::move(buckets[key & mask()]);
+    }
+    buckets = std::move(grown);
+  }
+
+  std::vector<std::vector<Value>> buckets;
+  Key current = 0;
+  size_t count = 0;
+};
+
+struct SearchStats {
+  /* nodes taken off the queue and settled */
+  std::uint64_t expanded = 0;
+  /* edges handed out by the neighbour generator */
+  std::uint64_t edges = 0;
+  /* entries put on the queue, sources included */
+  std::uint64_t pushed = 0;
+};
+
+/*
+ * Shortest paths over a graph whose nodes are numbered 0 to node_count - 1.
+ * The graph itself is only ever seen through a neighbour generator called as
+ *
+ *   neighbors(node, emit)
+ *
+ * that calls emit(next) for every edge in bfs(), or emit(next, weight) in
+ * dijkstra() and a_star(). Every search starts from all sources added since
+ * the last reset() and stops early at the first settled node is_target
+ * accepts, which it returns. Without a target the whole reachable graph is
+ * searched and distance() holds every shortest distance afterwards.
+ *
+ * Settled nodes are kept in a bitmap and distances in a flat array, both
+ * indexed by node, so a search allocates nothing per node.
+ */
+template <std::unsigned_integral Node = std::uint32_t, std::unsigned_integral Distance = std::uint32_t>
+class GraphSearch {
+public:
+  using node_t = Node;
+  using distance_t = Distance;
+
+  static constexpr distance_t unreachable = std::numeric_limits<distance_t>::max();
+
+  explicit GraphSearch(size_t node_count)
+    : distances(node_count, unreachable), settled_bits((node_count + 63) / 64, 0) {}
+
+  [[nodiscard]] size_t node_count() const noexcept { return distances.size(); }
+
+  void add_source(node_t node, distance_t distance = 0) {
+    assert(node < node_count());
+    if (distance < distances[node]) {
+      distances[node] = distance;
+      sources.push_back(node);
+    }
+  }
+
+  /* Forgets distances, settled nodes and sources, keeps the storage */
+  void reset() {
+    std::fill(distances.begin(), distances.end(), unreachable);
+    std::fill(settled_bits.begin(), settled_bits.end(), 0);
+    sources.clear();
+    fifo.clear();
+    queue.clear();
+    search_stats = {};
+  }
+
+  [[nodiscard]] distance_t distance(node_t node) const noexcept { return distances[node]; }
+
+  [[nodiscard]] bool settled(node_t node) const noexcept {
+    return (settled_bits[node / 64] >> (node % 64)) & 1;
+  }
+
+  [[nodiscard]] const SearchStats &stats() const noexcept { return search_stats; }
+
+  /* Every edge has length one, nodes are settled in the order they are reached */
+  template <typename Neighbors, typename IsTarget>
+  std::optional<node_t> bfs(Neighbors &&neighbors, IsTarget &&is_target) {
+    fifo.clear();
+    for (node_t source : sources) {
+      if (!settled(source)) {
+        settle(source);
+        fifo.push_back(source);
+        ++search_stats.pushed;
+      }
+    }
+
+    for (size_t head = 0; head < fifo.size(); ++head) {
+      node_t node = fifo[head];
+      ++search_stats.expanded;
+      if (is_target(node)) {
+        return node;
+      }
+      distance_t next_distance = distances[node] + 1;
+      neighbors(node, [&](node_t next) {
+        ++search_stats.edges;
+        if (!settled(next)) {
+          settle(next);
+          distances[next] = next_distance;
+          fifo.push_back(next);
+          ++search_stats.pushed;
+        }
+      });
+    }
+    return std::nullopt;
+  }
+
+  template <typename Neighbors>
+  void bfs(Neighbors &&neighbors) {
+    bfs(std::forward<Neighbors>(neighbors), [](node_t) { return false; });
+  }
+
+  /* Non negative integer weights, small ones keep the bucket ring short */
+  template <typename Neighbors, typename IsTarget>
+  std::optional<node_t> dijkstra(Neighbors &&neighbors, IsTarget &&is_target) {
+    return a_star(std::forward<Neighbors>(neighbors), [](node_t) -> distance_t { return 0; },
+                  std::forward<IsTarget>(is_target));
+  }
+
+  template <typename Neighbors>
+  void dijkstra(Neighbors &&neighbors) {
+    dijkstra(std::forward<Neighbors>(neighbors), [](node_t) { return false; });
+  }
+
+  /*
+   * Queue ordered by distance plus heuristic(node). The heuristic has to be
+   * consistent, never dropping by more than an edge weighs, or nodes could
+   * be settled too early.
+   */
+  template <typename Neighbors, typename Heuristic, typename IsTarget>
+  std::optional<node_t> a_star(Neighbors &&neighbors, Heuristic &&heuristic, IsTarget &&is_target) {
+    queue.clear();
+    for (node_t source : sources) {
+      queue.push(distances[source] + heuristic(source), source);
+    }
+    search_stats.pushed += sources.size();
+
+    while (!queue.empty()) {
+      node_t node = queue.pop().second;
+      /* Entries left behind when a node was pushed again with a shorter distance */
+      if (settled(node)) {
+        continue;
+      }
+      settle(node);
+      ++search_stats.expanded;
+      if (is_target(node)) {
+        return node;
+      }
+      distance_t node_distance = distances[node];
+      neighbors(node, [&](node_t next, distance_t weight) {
+        ++search_stats.edges;
+        distance_t next_distance = node_distance + weight;
+        if (!settled(next) && next_distance < distances[next]) {
+          distances[next] = next_distance;
+          queue.push(next_distance + heuristic(next), next);
+          ++search_stats.pushed;
+        }
+      });
+    }
+    return std::nullopt;
+  }
+
+private:
+  void settle(node_t node) noexcept { settled_bits[node / 64] |= std::uint64_t{1} << (node % 64); }
+
+  std::vector<distance_t> distances;
+  std::vector<std::uint64_t> settled_bits;
+  std::vector<node_t> sources;
+  std::vector<node_t> fifo;
+  BucketQueue<distance_t, node_t> queue;
+  SearchStats search_stats;
+};
+
+#endif /* end of include guard: GRAPH_SEARCH_H_M5QW2HZD */
@@ -0,0 +1,264 @@
+#ifndef GRID_H_T4XR8QEM
+#define GRID_H_T4XR8QEM
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "parsing.h"
+
+/* Allocator handing out storage aligned to Alignment bytes */
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+  [[nodiscard]] T *allocate(size_t count) {
+    return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T *pointer, size_t) noexcept {
+    ::operator delete(pointer, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  [[nodiscard]] bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept {
+    return true;
+  }
+};
+
+/* Every stride-th element starting at first, used for grid columns */
+template <typename T>
+class StridedSpan {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<T>;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+    iterator(T *current, std::ptrdiff_t stride) noexcept : current(current), stride(stride) {}
+
+    [[nodiscard]] reference operator*() const noexcept { return *current; }
+
+    iterator &operator++() noexcept {
+      current += stride;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      auto previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    [[nodiscard]] bool operator==(const iterator &other) const noexcept { return current == other.current; }
+
+  private:
+    T *current = nullptr;
+    std::ptrdiff_t stride = 1;
+  };
+
+  StridedSpan(T *first, size_t count, std::ptrdiff_t stride) noexcept : first(first), count(count), stride(stride) {}
+
+  [[nodiscard]] size_t size() const noexcept { return count; }
+
+  [[nodiscard]] T &operator[](size_t index) const noexcept {
+    return first[static_cast<std::ptrdiff_t>(index) * stride];
+  }
+
+  [[nodiscard]] StridedSpan subspan(size_t offset, size_t length) const noexcept {
+    assert(offset + length <= count);
+    return {first + static_cast<std::ptrdiff_t>(offset) * stride, length, stride};
+  }
+
+  /* The same elements last to first */
+  [[nodiscard]] StridedSpan reversed() const noexcept {
+    if (count == 0) {
+      return *this;
+    }
+    return {first + static_cast<std::ptrdiff_t>(count - 1) * stride, count, -stride};
+  }
+
+  [[nodiscard]] iterator begin() const noexcept { return {first, stride}; }
+  [[nodiscard]] iterator end() const noexcept { return {first + static_cast<std::ptrdiff_t>(count) * stride, stride}; }
+
+private:
+  T *first;
+  size_t count;
+  std::ptrdiff_t stride;
+};
+
+struct GridPoint {
+  std::ptrdiff_t x;
+  std::ptrdiff_t y;
+
+  [[nodiscard]] bool operator==(const GridPoint &) const noexcept = default;
+};
+
+/*
+ * Flat row major grid of width x height cells, surrounded by padding rows and
+ * columns of a sentinel value. Cells are addressed as (x, y) with both from
+ * -padding up to width or height + padding, so a search can look at the
+ * neighbours of any cell without bounds checks as long as the sentinel
+ * stops it at the border. The storage starts on a cache line.
+ *
+ * Cells can also be addressed by their offset into the storage, which is
+ * what neighbors4() and neighbors8() work with: the neighbours of a cell are
+ * a fixed distance away, at most one stride.
+ */
+template <typename T>
+class Grid2D {
+  static_assert(!std::is_same_v<T, bool>, "std::vector<bool> is packed, use char or std::uint8_t");
+
+public:
+  using value_type = T;
+  using index_t = std::ptrdiff_t;
+
+  Grid2D() = default;
+
+  Grid2D(index_t width, index_t height, T fill = T{}, index_t padding = 0, T sentinel = T{})
+    : grid_width(width), grid_height(height), grid_padding(padding), border(sentinel) {
+    assert(width >= 0 && height >= 0 && padding >= 0);
+    cells.assign(static_cast<size_t>(stride() * (height + 2 * padding)), sentinel);
+    fill_rows(0, height, fill);
+  }
+
+  /*
+   * One row per line of text, each character turned into a cell by to_cell.
+   * Every line is expected to be as long as the first.
+   */
+  template <std::invocable<char> ToCell>
+  [[nodiscard]] static Grid2D from_lines(std::string_view text, ToCell &&to_cell, index_t padding = 0,
+                                         T sentinel = T{}) {
+    index_t width = 0;
+    index_t height = 0;
+    for (std::string_view line : LineRange{text}) {
+      width = height == 0 ? static_cast<index_t>(line.size()) : width;
+      ++height;
+    }
+
+    Grid2D grid{width, height, T{}, padding, sentinel};
+    index_t y = 0;
+    for (std::string_view line : LineRange{text}) {
+      assert(static_cast<index_t>(line.size()) == width);
+      auto row = grid.row(y++);
+      std::transform(line.begin(), line.end(), row.begin(), to_cell);
+    }
+    return grid;
+  }
+
+  [[nodiscard]] static Grid2D from_lines(std::string_view text, index_t padding = 0, T sentinel = T{}) {
+    return from_lines(text, [](char c) { return static_cast<T>(c); }, padding, sentinel);
+  }
+
+  [[nodiscard]] index_t width() const noexcept { return grid_width; }
+  [[nodiscard]] index_t height() const noexcept { return grid_height; }
+  [[nodiscard]] index_t padding() const noexcept { return grid_padding; }
+  [[nodiscard]] index_t stride() const noexcept { return grid_width + 2 * grid_padding; }
+
+  [[nodiscard]] bool contains(index_t x, index_t y) const noexcept {
+    return x >= 0 && y >= 0 && x < grid_width && y < grid_height;
+  }
+
+  [[nodiscard]] size_t offset(index_t x, index_t y) const noexcept {
+    assert(x >= -grid_padding && x < grid_width + grid_padding);
+    assert(y >= -grid_padding && y < grid_height + grid_padding);
+    return static_cast<size_t>((y + grid_padding) * stride() + x + grid_padding);
+  }
+
+  [[nodiscard]] GridPoint position(size_t offset) const noexcept {
+    auto index = static_cast<index_t>(offset);
+    return {index % stride() - grid_padding, index / stride() - grid_padding};
+  }
+
+  [[nodiscard]] T &operator()(index_t x, index_t y) noexcept { return cells[offset(x, y)]; }
+  [[nodiscard]] const T &operator()(index_t x, index_t y) const noexcept { return cells[offset(x, y)]; }
+
+  [[nodiscard]] T &operator[](size_t offset) noexcept { return cells[offset]; }
+  [[nodiscard]] const T &operator[](size_t offset) const noexcept { return cells[offset]; }
+
+  /* Cells of row y without its padding */
+  [[nodiscard]] std::span<T> row(index_t y) noexcept {
+    return {cells.data() + offset(0, y), static_cast<size_t>(grid_width)};
+  }
+  [[nodiscard]] std::span<const T> row(index_t y) const noexcept {
+    return {cells.data() + offset(0, y), static_cast<size_t>(grid_width)};
+  }
+
+  /* Cells of column x without its padding */
+  [[nodiscard]] StridedSpan<T> column(index_t x) noexcept {
+    return {cells.data() + offset(x, 0), static_cast<size_t>(grid_height), stride()};
+  }
+  [[nodiscard]] StridedSpan<const T> column(index_t x) const noexcept {
+    return {cells.data() + offset(x, 0), static_cast<size_t>(grid_height), stride()};
+  }
+
+  /* Right, left, next row and previous row */
+  [[nodiscard]] std::array<size_t, 4> neighbors4(size_t offset) const noexcept {
+    auto row_step = static_cast<size_t>(stride());
+    return {offset + 1, offset - 1, offset + row_step, offset - row_step};
+  }
+
+  /* neighbors4() followed by the four diagonals */
+  [[nodiscard]] std::array<size_t, 8> neighbors8(size_t offset) const noexcept {
+    auto row_step = static_cast<size_t>(stride());
+    return {offset + 1,            offset - 1,           offset + row_step,     offset - row_step,
+            offset + row_step + 1, offset + row_step - 1, offset - row_step + 1, offset - row_step - 1};
+  }
+
+  /* Sets every cell but the padding */
+  void fill(T value) { fill_rows(0, grid_height, value); }
+
+  /*
+   * Adds count rows after the last one, filled with value. Rows are never
+   * moved, so this is as cheap as growing a vector and grids that grow keep
+   * their oldest row at y = 0.
+   */
+  void append_rows(index_t count, T value) {
+    cells.resize(static_cast<size_t>(stride() * (grid_height + count + 2 * grid_padding)), border);
+    fill_rows(grid_height, grid_height + count, value);
+    grid_height += count;
+  }
+
+  [[nodiscard]] T *data() noexcept { return cells.data(); }
+  [[nodiscard]] const T *data() const noexcept { return cells.data(); }
+
+private:
+  /* Rows first to last get value inside and the sentinel in their padding */
+  void fill_rows(index_t first, index_t last, T value) {
+    for (index_t y = first; y < last; ++y) {
+      T *row_begin = cells.data() + (y + grid_padding) * stride();
+      std::fill(row_begin, row_begin + grid_padding, border);
+      std::fill(row_begin + grid_padding, row_begin + grid_padding + grid_width, value);
+      std::fill(row_begin + grid_padding + grid_width, row_begin + stride(), border);
+    }
+  }
+
+  std::vector<T, AlignedAllocator<T>> cells;
+  index_t grid_width = 0;
+  index_t grid_height = 0;
+  index_t grid_padding = 0;
+  T border{};
+};
+
+#endif /* end of include guard: GRID_H_T4XR8QEM */
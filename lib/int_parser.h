@@ -0,0 +1,215 @@
+#ifndef INT_PARSER_H_J8TFW2QC
+#define INT_PARSER_H_J8TFW2QC
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Integer parsing for puzzle input. Digit runs are read eight bytes at a
+ * time as one 64-bit word (SWAR), the gaps between numbers are skipped
+ * sixteen bytes at a time with SSE2 where available. Neither checks for
+ * overflow, the inputs are trusted to fit the requested type.
+ */
+
+namespace int_parser_detail {
+constexpr std::uint64_t repeat(std::uint8_t byte) noexcept {
+  return 0x0101010101010101ULL * byte;
+}
+
+/* Number of leading digit bytes in the little endian word, 0 to 8 */
+[[nodiscard]] inline unsigned digit_count(std::uint64_t word) noexcept {
+  std::uint64_t high_nibble = (word & repeat(0xF0)) ^ repeat(0x30);
+  std::uint64_t low_nibble_over_nine = ((word & repeat(0x0F)) + repeat(0x06)) & repeat(0xF0);
+  std::uint64_t not_digit = high_nibble | low_nibble_over_nine;
+  /* high bit of every byte that is nonzero above */
+  std::uint64_t marks = (((not_digit & repeat(0x7F)) + repeat(0x7F)) | not_digit) & repeat(0x80);
+  return static_cast<unsigned>(std::countr_zero(marks)) / 8;
+}
+
+/* Value of the first count (1 to 8) digit bytes of the little endian word */
+[[nodiscard]] inline std::uint64_t digits_value(std::uint64_t word, unsigned count) noexcept {
+  /* Shifting the digits to the top leaves zero bytes, that is leading zeros */
+  word = (word - repeat('0')) << (8 * (8 - count));
+  word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+  word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+  return (word * 10000 + (word >> 32)) & 0xFFFFFFFFULL;
+}
+
+constexpr std::uint64_t powers_of_ten[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+[[nodiscard]] constexpr bool is_digit(char c) noexcept {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+/* Reads the digit run starting at first, returns the byte after it */
+[[nodiscard]] inline const char *parse_digits(const char *first, const char *last, std::uint64_t &value) noexcept {
+  std::uint64_t result = 0;
+  while (last - first >= 8) {
+    std::uint64_t word;
+    std::memcpy(&word, first, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+      word = __builtin_bswap64(word);
+    }
+    unsigned count = digit_count(word);
+    if (count == 0) {
+      value = result;
+      return first;
+    }
+    result = result * powers_of_ten[count] + digits_value(word, count);
+    first += count;
+    if (count < 8) {
+      value = result;
+      return first;
+    }
+  }
+  for (; first != last && is_digit(*first); ++first) {
+    result = result * 10 + static_cast<std::uint64_t>(*first - '0');
+  }
+  value = result;
+  return first;
+}
+
+/* First digit at or after first, last when there is none */
+[[nodiscard]] inline const char *find_digit(const char *first, const char *last) noexcept {
+  while (first != last && !is_digit(*first)) {
+    ++first;
+  }
+  return first;
+}
+
+#if defined(__SSE2__)
+/* Bit i set when first[i] is a digit, first must have 16 readable bytes */
+[[nodiscard]] inline unsigned digit_mask(const char *first) noexcept {
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+  __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                 _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+  return static_cast<unsigned>(_mm_movemask_epi8(digits));
+}
+#endif
+} // namespace int_parser_detail
+
+/*
+ * Parses one integer at the very start of [first, last), like
+ * std::from_chars: signed types accept a leading '-'. Returns the byte after
+ * the number, or first with value left untouched when there is none.
+ */
+template <std::integral T>
+[[nodiscard]] const char *parse_integer(const char *first, const char *last, T &value) noexcept {
+  bool negative = false;
+  const char *digits = first;
+  if constexpr (std::is_signed_v<T>) {
+    if (digits != last && *digits == '-') {
+      negative = true;
+      ++digits;
+    }
+  }
+  if (digits == last || !int_parser_detail::is_digit(*digits)) {
+    return first;
+  }
+  std::uint64_t magnitude;
+  const char *end = int_parser_detail::parse_digits(digits, last, magnitude);
+  value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+  return end;
+}
+
+struct ParsedIntegers {
+  /* values written to the output span */
+  size_t count;
+  /* text after the last parsed value, where the next call should resume */
+  std::string_view rest;
+};
+
+/*
+ * Pulls every integer out of text in order, skipping whatever separates
+ * them, until out is full. For signed types a '-' right before the digits
+ * makes the value negative, unsigned types ignore it so "2-4" reads as 2
+ * and 4.
+ */
+template <std::integral T, size_t Extent>
+[[nodiscard]] ParsedIntegers parse_integers(std::string_view text, std::span<T, Extent> out) noexcept {
+  const char *begin = text.data();
+  const char *last = begin + text.size();
+  const char *pos = begin;
+  size_t count = 0;
+
+  auto store = [&](const char *digits, std::uint64_t magnitude) {
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      negative = digits != begin && digits[-1] == '-';
+    }
+    out[count++] = static_cast<T>(negative ? 0 - magnitude : magnitude);
+  };
+
+#if defined(__SSE2__)
+  /*
+   * Every digit run inside a 16 byte block is found from one mask, runs of
+   * up to eight digits are then read with a single word load. The word load
+   * may reach 8 bytes past the block, so stay 24 bytes clear of the end.
+   */
+  while (count < out.size() && last - pos >= 24) {
+    unsigned mask = int_parser_detail::digit_mask(pos);
+    const char *next_block = pos + 16;
+    while (mask != 0 && count < out.size()) {
+      unsigned start = static_cast<unsigned>(std::countr_zero(mask));
+      unsigned run = static_cast<unsigned>(std::countr_one(mask >> start));
+      const char *digits = pos + start;
+      if (start + run == 16 || run > 8) {
+        /* the run may go on past the block, read it the long way */
+        std::uint64_t magnitude;
+        next_block = int_parser_detail::parse_digits(digits, last, magnitude);
+        store(digits, magnitude);
+        break;
+      }
+      std::uint64_t word;
+      std::memcpy(&word, digits, sizeof(word));
+      if constexpr (std::endian::native == std::endian::big) {
+        word = __builtin_bswap64(word);
+      }
+      store(digits, int_parser_detail::digits_value(word, run));
+      mask &= ~0U << (start + run);
+      next_block = digits + run;
+    }
+    if (mask == 0 && count < out.size() && next_block < pos + 16) {
+      next_block = pos + 16;
+    }
+    pos = next_block;
+  }
+#endif
+
+  while (count < out.size()) {
+    pos = int_parser_detail::find_digit(pos, last);
+    if (pos == last) {
+      break;
+    }
+    std::uint64_t magnitude;
+    const char *digits = pos;
+    pos = int_parser_detail::parse_digits(digits, last, magnitude);
+    store(digits, magnitude);
+  }
+
+  return {count, std::string_view(pos, last - pos)};
+}
+
+/* parse_integers over all of text, for when the count is not known up front */
+template <std::integral T>
+void append_integers(std::string_view text, std::vector<T> &values) {
+  T buffer[256];
+  ParsedIntegers parsed{std::size(buffer), text};
+  while (parsed.count == std::size(buffer)) {
+    parsed = parse_integers(parsed.rest, std::span<T>{buffer});
+    values.insert(values.end(), buffer, buffer + parsed.count);
+  }
+}
+
+#endif /* end of include guard: INT_PARSER_H_J8TFW2QC */
@@ -0,0 +1,27 @@
+#ifndef JSON_H_K7QD2VXN
+#define JSON_H_K7QD2VXN
+
+#include <cstdio>
+#include <string_view>
+
+/*
+ * text as a quoted JSON string. Quotes and backslashes are escaped, other
+ * control characters written as \u00XX; everything else, UTF-8 included,
+ * goes out as is. Shared by the trace writer and the bench JSON reports.
+ */
+inline void write_json_string(std::FILE *out, std::string_view text) {
+  std::fputc('"', out);
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      std::fputc('\\', out);
+      std::fputc(c, out);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      std::fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+    } else {
+      std::fputc(c, out);
+    }
+  }
+  std::fputc('"', out);
+}
+
+#endif /* end of include guard: JSON_H_K7QD2VXN */
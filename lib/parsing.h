@@ -0,0 +1,166 @@
+#ifndef PARSING_H_QX7RM2KD
+#define PARSING_H_QX7RM2KD
+
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include "int_parser.h"
+
+/*
+ * Iterates the lines of a buffer as string_views pointing straight into it.
+ * Empty lines are kept, the newline after the last line does not produce an
+ * extra empty line.
+ */
+class LineRange {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::string_view;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    iterator() noexcept = default;
+
+    iterator(const char *begin, const char *end) noexcept : next_line(begin), data_end(end) {
+      if (next_line == data_end) {
+        next_line = nullptr;
+        return;
+      }
+      read_line();
+    }
+
+    [[nodiscard]] std::string_view operator*() const noexcept { return line; }
+
+    [[nodiscard]] const std::string_view *operator->() const noexcept { return &line; }
+
+    iterator &operator++() noexcept {
+      if (next_line == data_end) {
+        next_line = nullptr;
+        line = {};
+      } else {
+        read_line();
+      }
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator old = *this;
+      ++(*this);
+      return old;
+    }
+
+    [[nodiscard]] bool operator==(const iterator &other) const noexcept {
+      return next_line == other.next_line;
+    }
+
+  private:
+    void read_line() noexcept {
+      auto newline = static_cast<const char *>(std::memchr(next_line, '\n', data_end - next_line));
+      auto line_end = newline != nullptr ? newline : data_end;
+      line = std::string_view(next_line, line_end - next_line);
+      next_line = newline != nullptr ? newline + 1 : data_end;
+    }
+
+    std::string_view line;
+    const char *next_line = nullptr;
+    const char *data_end = nullptr;
+  };
+
+  [[nodiscard]] explicit LineRange(std::string_view data) noexcept : data(data) {}
+
+  [[nodiscard]] iterator begin() const noexcept { return iterator{data.data(), data.data() + data.size()}; }
+
+  [[nodiscard]] iterator end() const noexcept { return iterator{}; }
+
+private:
+  std::string_view data;
+};
+
+/*
+ * Splits a string_view into fields separated by any of the delimiter
+ * characters. Runs of delimiters count as one, so empty fields are skipped.
+ */
+class FieldRange {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::string_view;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    iterator() noexcept = default;
+
+    iterator(std::string_view text, std::string_view delimiters) noexcept : rest(text), delimiters(delimiters) {
+      read_field();
+    }
+
+    [[nodiscard]] std::string_view operator*() const noexcept { return field; }
+
+    [[nodiscard]] const std::string_view *operator->() const noexcept { return &field; }
+
+    iterator &operator++() noexcept {
+      read_field();
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator old = *this;
+      ++(*this);
+      return old;
+    }
+
+    [[nodiscard]] bool operator==(const iterator &other) const noexcept {
+      return field.data() == other.field.data();
+    }
+
+  private:
+    void read_field() noexcept {
+      auto start = rest.find_first_not_of(delimiters);
+      if (start == std::string_view::npos) {
+        field = {};
+        rest = {};
+        return;
+      }
+      rest.remove_prefix(start);
+      auto stop = std::min(rest.find_first_of(delimiters), rest.size());
+      field = rest.substr(0, stop);
+      rest.remove_prefix(stop);
+    }
+
+    std::string_view field;
+    std::string_view rest;
+    std::string_view delimiters;
+  };
+
+  [[nodiscard]] FieldRange(std::string_view text, std::string_view delimiters) noexcept : text(text), delimiters(delimiters) {}
+
+  [[nodiscard]] iterator begin() const noexcept { return iterator{text, delimiters}; }
+
+  [[nodiscard]] iterator end() const noexcept { return iterator{}; }
+
+private:
+  std::string_view text;
+  std::string_view delimiters;
+};
+
+[[nodiscard]] inline FieldRange split(std::string_view text, std::string_view delimiters = " ") noexcept {
+  return FieldRange{text, delimiters};
+}
+
+/*
+ * Parses a whole field as a number, returns 0 when it holds none.
+ */
+template <std::integral T>
+[[nodiscard]] T parse_number(std::string_view sv) noexcept {
+  T value{};
+  (void)parse_integer(sv.data(), sv.data() + sv.size(), value);
+  return value;
+}
+
+#endif /* end of include guard: PARSING_H_QX7RM2KD */
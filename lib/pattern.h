@@ -0,0 +1,301 @@
+#ifndef PATTERN_H_V6PZC1NL
+#define PATTERN_H_V6PZC1NL
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+/*
+ * Fixed input formats written as compile time patterns, matched without
+ * allocating and without backtracking:
+ *
+ *   constexpr Pattern<"move {i} from {i} to {i}"> command_pattern;
+ *   for (const auto &captures : command_pattern.scan(text)) { ... }
+ *
+ * In a pattern
+ *   {i}  captures an integer, an optional '-' and at least one digit
+ *   {w}  captures a word, a run of letters and digits
+ *   {c}  captures one character that is not whitespace
+ *   {l}  captures the rest of the line, possibly empty, without the newline
+ *   ' '  any run of whitespace, newlines included, matches one or more
+ *        whitespace characters in the input
+ *   x?   the character x is optional
+ * and every other character matches itself. Captures are string_views into
+ * the scanned text, numbers are left to parse_number().
+ */
+
+template <size_t N>
+struct FixedString {
+  char chars[N]{};
+
+  consteval FixedString(const char (&text)[N]) noexcept {
+    std::copy_n(text, N, chars);
+  }
+
+  [[nodiscard]] constexpr std::string_view view() const noexcept { return {chars, N - 1}; }
+};
+
+namespace pattern_detail {
+enum class TokenKind : char {
+  literal,
+  optional_literal,
+  whitespace,
+  integer,
+  word,
+  character,
+  line,
+};
+
+struct Token {
+  TokenKind kind = TokenKind::literal;
+  char c = '\0';
+};
+
+[[nodiscard]] constexpr bool is_space(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+[[nodiscard]] constexpr bool is_digit(char c) noexcept {
+  return c >= '0' && c <= '9';
+}
+
+[[nodiscard]] constexpr bool is_word(char c) noexcept {
+  return is_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+[[nodiscard]] constexpr bool is_capture(TokenKind kind) noexcept {
+  return kind == TokenKind::integer || kind == TokenKind::word || kind == TokenKind::character ||
+         kind == TokenKind::line;
+}
+
+/* Calls emit for every token of the pattern, fails to compile on bad syntax */
+consteval void tokenize(std::string_view pattern, auto emit) {
+  for (size_t idx = 0; idx < pattern.size(); ++idx) {
+    char c = pattern[idx];
+    if (is_space(c)) {
+      while (idx + 1 < pattern.size() && is_space(pattern[idx + 1])) {
+        ++idx;
+      }
+      emit(Token{TokenKind::whitespace});
+    } else if (c == '{') {
+      if (idx + 2 >= pattern.size() || pattern[idx + 2] != '}') {
+        throw "unterminated capture in pattern";
+      }
+      switch (pattern[idx + 1]) {
+        case 'i': emit(Token{TokenKind::integer}); break;
+        case 'w': emit(Token{TokenKind::word}); break;
+        case 'c': emit(Token{TokenKind::character}); break;
+        case 'l': emit(Token{TokenKind::line}); break;
+        default: throw "unknown capture in pattern";
+      }
+      idx += 2;
+    } else if (idx + 1 < pattern.size() && pattern[idx + 1] == '?') {
+      emit(Token{TokenKind::optional_literal, c});
+      ++idx;
+    } else {
+      emit(Token{TokenKind::literal, c});
+    }
+  }
+}
+} // namespace pattern_detail
+
+template <FixedString Text>
+class Pattern {
+  using Token = pattern_detail::Token;
+  using TokenKind = pattern_detail::TokenKind;
+
+  static consteval size_t count_tokens() {
+    size_t count = 0;
+    pattern_detail::tokenize(Text.view(), [&count](Token) { ++count; });
+    return count;
+  }
+
+  static consteval auto make_tokens() {
+    std::array<Token, count_tokens()> tokens{};
+    size_t idx = 0;
+    pattern_detail::tokenize(Text.view(), [&](Token token) { tokens[idx++] = token; });
+    return tokens;
+  }
+
+  static constexpr auto tokens = make_tokens();
+
+  static consteval size_t count_captures() {
+    return static_cast<size_t>(std::count_if(tokens.begin(), tokens.end(), [](Token token) {
+      return pattern_detail::is_capture(token.kind);
+    }));
+  }
+
+  /* Leading literal characters, searched for before trying a match */
+  static consteval size_t count_prefix() {
+    size_t count = 0;
+    while (count < tokens.size() && tokens[count].kind == TokenKind::literal) {
+      ++count;
+    }
+    return count;
+  }
+
+  static constexpr auto prefix_chars = [] {
+    std::array<char, count_prefix()> chars{};
+    for (size_t idx = 0; idx < chars.size(); ++idx) {
+      chars[idx] = tokens[idx].c;
+    }
+    return chars;
+  }();
+
+public:
+  static constexpr size_t capture_count = count_captures();
+
+  using captures_t = std::array<std::string_view, capture_count>;
+
+  /*
+   * Matches the pattern at the very start of text. Returns the number of
+   * characters it took, captures are only valid when it matched.
+   */
+  [[nodiscard]] static constexpr std::optional<size_t> match_prefix(std::string_view text,
+                                                                    captures_t &captures) noexcept {
+    size_t pos = 0;
+    size_t capture = 0;
+    auto take_while = [&](auto predicate) {
+      size_t start = pos;
+      while (pos < text.size() && predicate(text[pos])) {
+        ++pos;
+      }
+      return pos - start;
+    };
+
+    for (const Token &token : tokens) {
+      size_t start = pos;
+      switch (token.kind) {
+        case TokenKind::literal:
+          if (pos >= text.size() || text[pos] != token.c) {
+            return std::nullopt;
+          }
+          ++pos;
+          break;
+        case TokenKind::optional_literal:
+          if (pos < text.size() && text[pos] == token.c) {
+            ++pos;
+          }
+          break;
+        case TokenKind::whitespace:
+          if (take_while(pattern_detail::is_space) == 0) {
+            return std::nullopt;
+          }
+          break;
+        case TokenKind::integer:
+          if (pos < text.size() && text[pos] == '-') {
+            ++pos;
+          }
+          if (take_while(pattern_detail::is_digit) == 0) {
+            return std::nullopt;
+          }
+          break;
+        case TokenKind::word:
+          if (take_while(pattern_detail::is_word) == 0) {
+            return std::nullopt;
+          }
+          break;
+        case TokenKind::character:
+          if (pos >= text.size() || pattern_detail::is_space(text[pos])) {
+            return std::nullopt;
+          }
+          ++pos;
+          break;
+        case TokenKind::line:
+          take_while([](char c) { return c != '\n' && c != '\r'; });
+          break;
+      }
+      if (pattern_detail::is_capture(token.kind)) {
+        captures[capture++] = text.substr(start, pos - start);
+      }
+    }
+    return pos;
+  }
+
+  /* Matches the pattern against the whole of text */
+  [[nodiscard]] static constexpr std::optional<captures_t> match(std::string_view text) noexcept {
+    captures_t captures;
+    if (auto length = match_prefix(text, captures); length && *length == text.size()) {
+      return captures;
+    }
+    return std::nullopt;
+  }
+
+  /*
+   * Every non overlapping match in a text, leftmost first, skipping
+   * whatever does not match like a regex search would.
+   */
+  class ScanRange {
+  public:
+    class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = captures_t;
+      using pointer = const captures_t *;
+      using reference = const captures_t &;
+
+      iterator() noexcept = default;
+
+      explicit iterator(std::string_view text) noexcept : rest(text), at_end(false) { find_next(); }
+
+      [[nodiscard]] const captures_t &operator*() const noexcept { return captures; }
+
+      [[nodiscard]] const captures_t *operator->() const noexcept { return &captures; }
+
+      iterator &operator++() noexcept {
+        find_next();
+        return *this;
+      }
+
+      iterator operator++(int) noexcept {
+        iterator old = *this;
+        ++(*this);
+        return old;
+      }
+
+      [[nodiscard]] bool operator==(const iterator &other) const noexcept {
+        return at_end == other.at_end && (at_end || rest.data() == other.rest.data());
+      }
+
+    private:
+      void find_next() noexcept {
+        constexpr std::string_view prefix{prefix_chars.data(), prefix_chars.size()};
+        while (!rest.empty()) {
+          auto start = rest.find(prefix);
+          if (start == std::string_view::npos) {
+            break;
+          }
+          rest.remove_prefix(start);
+          if (auto length = match_prefix(rest, captures); length && *length > 0) {
+            rest.remove_prefix(*length);
+            return;
+          }
+          rest.remove_prefix(1);
+        }
+        rest = {};
+        at_end = true;
+      }
+
+      std::string_view rest;
+      captures_t captures{};
+      bool at_end = true;
+    };
+
+    [[nodiscard]] explicit ScanRange(std::string_view text) noexcept : text(text) {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator{text}; }
+
+    [[nodiscard]] iterator end() const noexcept { return iterator{}; }
+
+  private:
+    std::string_view text;
+  };
+
+  [[nodiscard]] static constexpr ScanRange scan(std::string_view text) noexcept { return ScanRange{text}; }
+};
+
+#endif /* end of include guard: PATTERN_H_V6PZC1NL */
@@ -0,0 +1,126 @@
+#include "perf_counters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+struct EventConfig {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+constexpr std::array<EventConfig, perf_event_count> event_configs{{
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+
+constexpr std::array<std::string_view, perf_event_count> event_names{
+  "cycles", "instructions", "L1D misses", "LLC misses", "branch misses"};
+
+[[nodiscard]] bool perf_enabled() noexcept {
+  static const bool enabled = [] {
+    const char *env = std::getenv("AOC_PERF");
+    return env != nullptr && *env != '\0' && std::strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
+void warn_unavailable(int error) noexcept {
+  static std::atomic_flag warned = ATOMIC_FLAG_INIT;
+  if (!warned.test_and_set()) {
+    std::fprintf(stderr, "perf counters unavailable (%s), timing wall clock only\n", std::strerror(error));
+  }
+}
+
+[[nodiscard]] int open_event(const EventConfig &event, int group_fd) noexcept {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+} // namespace
+
+std::string_view perf_event_name(size_t event) noexcept {
+  return event < perf_event_count ? event_names[event] : "";
+}
+
+PerfCounters *PerfCounters::for_this_thread() {
+  if (!perf_enabled()) {
+    return nullptr;
+  }
+  thread_local std::unique_ptr<PerfCounters> counters{new PerfCounters()};
+  return counters->opened > 0 ? counters.get() : nullptr;
+}
+
+PerfCounters::PerfCounters() {
+  fds.fill(-1);
+  int last_error = 0;
+  for (size_t event = 0; event < perf_event_count; ++event) {
+    int fd = open_event(event_configs[event], leader_fd);
+    if (fd == -1) {
+      last_error = errno;
+      continue;
+    }
+    if (leader_fd == -1) {
+      leader_fd = fd;
+    }
+    fds[event] = fd;
+    slots[opened++] = event;
+    available |= static_cast<perf_mask_t>(1u << event);
+  }
+
+  if (leader_fd == -1) {
+    warn_unavailable(last_error);
+    return;
+  }
+  ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds) {
+    if (fd != -1) {
+      close(fd);
+    }
+  }
+}
+
+bool PerfCounters::read(perf_values_t &values) const noexcept {
+  /* nr, time_enabled, time_running, then one value per opened event */
+  std::array<std::uint64_t, 3 + perf_event_count> buffer{};
+  if (::read(leader_fd, buffer.data(), sizeof(buffer)) < static_cast<ssize_t>((3 + opened) * sizeof(std::uint64_t))) {
+    return false;
+  }
+
+  std::uint64_t time_enabled = buffer[1];
+  std::uint64_t time_running = buffer[2];
+  values.fill(0);
+  for (size_t i = 0; i < opened; ++i) {
+    std::uint64_t value = buffer[3 + i];
+    /* The group was multiplexed with other users of the PMU, extrapolate */
+    if (time_running > 0 && time_running < time_enabled) {
+      value = static_cast<std::uint64_t>(static_cast<double>(value) * static_cast<double>(time_enabled) /
+                                         static_cast<double>(time_running));
+    }
+    values[slots[i]] = value;
+  }
+  return true;
+}
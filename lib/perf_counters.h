@@ -0,0 +1,53 @@
+#ifndef PERF_COUNTERS_H_T6HC2QNV
+#define PERF_COUNTERS_H_T6HC2QNV
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum PerfEvent : size_t {
+  perf_cycles,
+  perf_instructions,
+  perf_l1d_misses,
+  perf_llc_misses,
+  perf_branch_misses,
+  perf_event_count
+};
+
+using perf_values_t = std::array<std::uint64_t, perf_event_count>;
+using perf_mask_t = std::uint8_t;
+
+[[nodiscard]] std::string_view perf_event_name(size_t event) noexcept;
+
+/*
+ * Hardware counters for the calling thread, opened as one perf_event_open
+ * group so a single read() returns all of them. Only user space is counted.
+ * Enabled with AOC_PERF=1; events the kernel or CPU refuses are left out and
+ * when none can be opened the profiler keeps timing wall clock only.
+ */
+class PerfCounters {
+public:
+  /* nullptr when counters are disabled or unavailable on this thread */
+  [[nodiscard]] static PerfCounters *for_this_thread();
+
+  [[nodiscard]] bool read(perf_values_t &values) const noexcept;
+
+  [[nodiscard]] perf_mask_t mask() const noexcept { return available; }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  ~PerfCounters();
+
+private:
+  PerfCounters();
+
+  int leader_fd = -1;
+  std::array<int, perf_event_count> fds;
+  std::array<size_t, perf_event_count> slots{};
+  size_t opened = 0;
+  perf_mask_t available = 0;
+};
+
+#endif /* end of include guard: PERF_COUNTERS_H_T6HC2QNV */
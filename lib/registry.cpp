@@ -0,0 +1,15 @@
+#include "registry.h"
+
+#include <algorithm>
+
+SolutionRegistry &SolutionRegistry::instance() {
+  static SolutionRegistry registry;
+  return registry;
+}
+
+void SolutionRegistry::add(const Solution &solution) {
+  auto position = std::upper_bound(registered.begin(), registered.end(), solution, [](const Solution &a, const Solution &b) {
+    return a.day != b.day ? a.day < b.day : a.part < b.part;
+  });
+  registered.insert(position, solution);
+}
@@ -0,0 +1,42 @@
+#ifndef REGISTRY_H_K3VQ8ZUD
+#define REGISTRY_H_K3VQ8ZUD
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Runs one part against the input at input_path and returns its answer */
+using solver_fn_t = std::string (*)(const std::string &input_path);
+
+struct Solution {
+  int day;
+  int part;
+  /* input file inside the day directory, e.g. "input.txt" */
+  std::string_view input_name;
+  /* known answer for the committed puzzle input, empty when unknown */
+  std::string_view expected;
+  solver_fn_t solve;
+};
+
+/*
+ * Every day registers its parts here from a static RegisterSolution so
+ * tools linking several days (aoc_bench) can run them without a main().
+ */
+class SolutionRegistry {
+public:
+  [[nodiscard]] static SolutionRegistry &instance();
+
+  void add(const Solution &solution);
+
+  /* Sorted by day, then part */
+  [[nodiscard]] const std::vector<Solution> &solutions() const noexcept { return registered; }
+
+private:
+  std::vector<Solution> registered;
+};
+
+struct RegisterSolution {
+  RegisterSolution(const Solution &solution) { SolutionRegistry::instance().add(solution); }
+};
+
+#endif /* end of include guard: REGISTRY_H_K3VQ8ZUD */
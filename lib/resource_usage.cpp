@@ -0,0 +1,60 @@
+#include "resource_usage.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+bool resource_usage_enabled() noexcept {
+  static const bool enabled = [] {
+    const char *env = std::getenv("AOC_RUSAGE");
+    return env != nullptr && *env != '\0' && std::strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
+bool read_resource_usage(ResourceUsage &usage) noexcept {
+  rusage raw{};
+  if (getrusage(RUSAGE_THREAD, &raw) != 0) {
+    return false;
+  }
+  usage.max_rss_kb = raw.ru_maxrss;
+  usage.minor_faults = raw.ru_minflt;
+  usage.major_faults = raw.ru_majflt;
+  usage.voluntary_switches = raw.ru_nvcsw;
+  usage.involuntary_switches = raw.ru_nivcsw;
+  return true;
+}
+
+std::int64_t read_peak_rss_kb() noexcept {
+  /* Plain read() into a stack buffer, no stdio, so nothing is allocated */
+  int fd = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  char buffer[4096];
+  ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (length <= 0) {
+    return -1;
+  }
+  buffer[length] = '\0';
+
+  const char *field = std::strstr(buffer, "VmHWM:");
+  if (field == nullptr) {
+    return -1;
+  }
+  return std::strtoll(field + std::strlen("VmHWM:"), nullptr, 10);
+}
+
+bool reset_peak_rss() noexcept {
+  int fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  bool written = write(fd, "5", 1) == 1;
+  close(fd);
+  return written;
+}
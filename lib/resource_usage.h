@@ -0,0 +1,33 @@
+#ifndef RESOURCE_USAGE_H_F2MW7TJR
+#define RESOURCE_USAGE_H_F2MW7TJR
+
+#include <cstdint>
+
+/*
+ * getrusage(RUSAGE_THREAD) of the calling thread. Faults and context
+ * switches are per thread, max_rss_kb is the process wide peak resident set.
+ */
+struct ResourceUsage {
+  std::int64_t max_rss_kb = 0;
+  std::int64_t minor_faults = 0;
+  std::int64_t major_faults = 0;
+  std::int64_t voluntary_switches = 0;
+  std::int64_t involuntary_switches = 0;
+};
+
+/* AOC_RUSAGE=1 turns on resource usage per TimeIt scope */
+[[nodiscard]] bool resource_usage_enabled() noexcept;
+
+[[nodiscard]] bool read_resource_usage(ResourceUsage &usage) noexcept;
+
+/* VmHWM from /proc/self/status in kB, -1 when it cannot be read */
+[[nodiscard]] std::int64_t read_peak_rss_kb() noexcept;
+
+/*
+ * Lowers VmHWM and ru_maxrss to the current resident set through
+ * /proc/self/clear_refs, so the next peak read covers only what follows.
+ * Returns false where the kernel does not allow it.
+ */
+bool reset_peak_rss() noexcept;
+
+#endif /* end of include guard: RESOURCE_USAGE_H_F2MW7TJR */
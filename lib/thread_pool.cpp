@@ -0,0 +1,157 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+thread_local int worker_index = -1;
+thread_local const ThreadPool *worker_pool = nullptr;
+} // namespace
+
+ThreadPool::ThreadPool(size_t thread_count, bool work_stealing, worker_start_t on_start)
+  : work_stealing(work_stealing), on_start(std::move(on_start)) {
+  thread_count = std::max<size_t>(1, thread_count);
+  for (size_t idx = 0; idx < thread_count; ++idx) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+  for (size_t idx = 0; idx < thread_count; ++idx) {
+    threads.emplace_back([this, idx] { run(idx); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  wait();
+  {
+    std::lock_guard lock(state_mutex);
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+int ThreadPool::current_worker() noexcept {
+  return worker_index;
+}
+
+bool ThreadPool::is_worker() const noexcept {
+  return worker_pool == this;
+}
+
+std::vector<std::uint64_t> ThreadPool::busy_ns() const {
+  std::vector<std::uint64_t> result;
+  for (const auto &worker : workers) {
+    result.push_back(worker->busy_ns.load(std::memory_order_relaxed));
+  }
+  return result;
+}
+
+void ThreadPool::submit(task_t task) {
+  size_t target = 0;
+  if (worker_pool == this) {
+    target = static_cast<size_t>(worker_index);
+  } else {
+    std::lock_guard lock(state_mutex);
+    target = next_worker++ % workers.size();
+  }
+
+  /*
+   * Counted and pushed under state_mutex, in the same lock order as the
+   * wait in run(): a worker either sees the task when it checks for work,
+   * or is already waiting when notified. The counts go up before the
+   * worker lock is released, so a worker that takes and finishes the task
+   * right away cannot bring queued or pending below it.
+   */
+  {
+    std::lock_guard lock(state_mutex);
+    std::lock_guard worker_lock(workers[target]->mutex);
+    workers[target]->tasks.push_back(std::move(task));
+    ++queued;
+    ++pending;
+  }
+  if (work_stealing) {
+    work_available.notify_one();
+  } else {
+    work_available.notify_all();
+  }
+}
+
+void ThreadPool::wait() {
+  std::unique_lock lock(state_mutex);
+  all_done.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::take_task(size_t index, task_t &task) {
+  {
+    auto &own = *workers[index];
+    std::lock_guard lock(own.mutex);
+    if (!own.tasks.empty() && !work_stealing) {
+      task = std::move(own.tasks.front());
+      own.tasks.pop_front();
+      return true;
+    }
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (size_t offset = 1; work_stealing && offset < workers.size(); ++offset) {
+    auto &victim = *workers[(index + offset) % workers.size()];
+    std::lock_guard lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::run(size_t index) {
+  worker_index = static_cast<int>(index);
+  worker_pool = this;
+  if (on_start) {
+    on_start(index);
+  }
+
+  while (true) {
+    task_t task;
+    if (take_task(index, task)) {
+      {
+        std::lock_guard lock(state_mutex);
+        --queued;
+      }
+      auto start = std::chrono::steady_clock::now();
+      task();
+      workers[index]->busy_ns.fetch_add(
+        static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()),
+        std::memory_order_relaxed);
+      bool finished = false;
+      {
+        std::lock_guard lock(state_mutex);
+        finished = --pending == 0;
+      }
+      if (finished) {
+        all_done.notify_all();
+      }
+      continue;
+    }
+
+    /* Without stealing, tasks queued for other workers are no reason to wake up */
+    std::unique_lock lock(state_mutex);
+    work_available.wait(lock, [this, index] {
+      if (stopping || (work_stealing && queued > 0)) {
+        return true;
+      }
+      std::lock_guard own_lock(workers[index]->mutex);
+      return !workers[index]->tasks.empty();
+    });
+    if (stopping && queued == 0) {
+      return;
+    }
+  }
+}
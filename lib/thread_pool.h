@@ -0,0 +1,82 @@
+#ifndef THREAD_POOL_H_R2WN5JXE
+#define THREAD_POOL_H_R2WN5JXE
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of workers, each with its own task deque. A worker runs its
+ * newest task first and steals the oldest task of a sibling once its own
+ * deque is empty. Tasks submitted from outside the pool are dealt round
+ * robin, tasks submitted from a worker go to that worker's deque.
+ *
+ * Without work stealing every worker runs only its own tasks, oldest first,
+ * so which worker runs a task and in which order depends on nothing but the
+ * order tasks were submitted in.
+ */
+class ThreadPool {
+public:
+  using task_t = std::function<void()>;
+  /* Called on every worker with its index before it runs any task */
+  using worker_start_t = std::function<void(size_t)>;
+
+  explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency(), bool work_stealing = true,
+                      worker_start_t on_start = {});
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /* Finishes every queued task before joining */
+  ~ThreadPool();
+
+  void submit(task_t task);
+
+  /* Blocks until every task submitted so far has finished */
+  void wait();
+
+  [[nodiscard]] size_t size() const noexcept { return workers.size(); }
+
+  /* Index of the calling worker thread, -1 outside any pool */
+  [[nodiscard]] static int current_worker() noexcept;
+
+  /* True on the threads of this pool */
+  [[nodiscard]] bool is_worker() const noexcept;
+
+  /* Time each worker has spent running tasks so far, by worker index */
+  [[nodiscard]] std::vector<std::uint64_t> busy_ns() const;
+
+private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<task_t> tasks;
+    std::atomic<std::uint64_t> busy_ns{0};
+  };
+
+  void run(size_t index);
+
+  [[nodiscard]] bool take_task(size_t index, task_t &task);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  std::mutex state_mutex;
+  std::condition_variable work_available;
+  std::condition_variable all_done;
+  /* tasks sitting in a deque, and tasks submitted but not finished */
+  size_t queued = 0;
+  size_t pending = 0;
+  size_t next_worker = 0;
+  bool stopping = false;
+  bool work_stealing = true;
+  worker_start_t on_start;
+};
+
+#endif /* end of include guard: THREAD_POOL_H_R2WN5JXE */
@@ -0,0 +1,349 @@
+#include "time_it.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+thread_local ProfileNode *current_node = nullptr;
+
+/*
+ * Top level scopes timed with AOC_RUSAGE, process wide: how many have been
+ * opened in the high 32 bits, how many are open right now in the low 32
+ * bits. One atomic so a scope sees both at the same instant.
+ */
+std::atomic<std::uint64_t> root_scopes{0};
+constexpr std::uint64_t root_opened = std::uint64_t{1} << 32;
+constexpr std::uint64_t roots_open_mask = root_opened - 1;
+
+void print_node(std::FILE *out, const ProfileNode &node, size_t depth, std::uint64_t parent_ns) {
+  double share = parent_ns > 0 ? (100.0 * static_cast<double>(node.total_ns)) / static_cast<double>(parent_ns) : 100.0;
+  std::string label = std::string(depth * 2, ' ') + node.name;
+  std::fprintf(out, "%-40s %8lu %12s %12s %12s %12s %6.1f%%\n", label.c_str(), node.calls,
+               format_duration(node.total_ns).c_str(),
+               format_duration(node.total_ns / std::max<std::uint64_t>(node.calls, 1)).c_str(),
+               format_duration(node.min_ns).c_str(),
+               format_duration(node.max_ns).c_str(), share);
+
+  for (const auto &child : node.children) {
+    print_node(out, *child, depth + 1, node.total_ns);
+  }
+}
+
+[[nodiscard]] perf_mask_t tree_counter_mask(const ProfileNode &node) noexcept {
+  perf_mask_t mask = node.counter_mask;
+  for (const auto &child : node.children) {
+    mask |= tree_counter_mask(*child);
+  }
+  return mask;
+}
+
+/* Misses are shown per thousand instructions so scopes of any length compare */
+void print_counters(std::FILE *out, const ProfileNode &node, size_t depth) {
+  auto has = [&node](size_t event) { return (node.counter_mask & (1u << event)) != 0; };
+  auto per_kilo_instruction = [&](size_t event) -> std::string {
+    if (!has(event) || !has(perf_instructions) || node.counters[perf_instructions] == 0) {
+      return "-";
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f",
+                  1000.0 * static_cast<double>(node.counters[event]) / static_cast<double>(node.counters[perf_instructions]));
+    return buffer;
+  };
+  auto count = [&](size_t event) -> std::string {
+    return has(event) ? std::to_string(node.counters[event]) : "-";
+  };
+
+  std::string ipc = "-";
+  if (has(perf_cycles) && has(perf_instructions) && node.counters[perf_cycles] > 0) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f",
+                  static_cast<double>(node.counters[perf_instructions]) / static_cast<double>(node.counters[perf_cycles]));
+    ipc = buffer;
+  }
+
+  std::string label = std::string(depth * 2, ' ') + node.name;
+  std::fprintf(out, "%-40s %14s %14s %6s %10s %10s %10s\n", label.c_str(), count(perf_cycles).c_str(),
+               count(perf_instructions).c_str(), ipc.c_str(), per_kilo_instruction(perf_l1d_misses).c_str(),
+               per_kilo_instruction(perf_llc_misses).c_str(), per_kilo_instruction(perf_branch_misses).c_str());
+
+  for (const auto &child : node.children) {
+    print_counters(out, *child, depth + 1);
+  }
+}
+
+[[nodiscard]] std::uint64_t tree_allocations(const ProfileNode &node) noexcept {
+  std::uint64_t allocations = node.allocations;
+  for (const auto &child : node.children) {
+    allocations += tree_allocations(*child);
+  }
+  return allocations;
+}
+
+[[nodiscard]] bool tree_has_usage(const ProfileNode &node) noexcept {
+  return node.has_usage || std::any_of(node.children.begin(), node.children.end(), [](const auto &child) {
+    return tree_has_usage(*child);
+  });
+}
+
+void print_usage(std::FILE *out, const ProfileNode &node, size_t depth) {
+  std::string label = std::string(depth * 2, ' ') + node.name;
+  if (!node.has_usage) {
+    std::fprintf(out, "%-40s\n", label.c_str());
+  } else {
+    std::string growth = node.peak_rss_growth_kb >= 0 ? format_bytes(node.peak_rss_growth_kb * 1024) : "-";
+    std::fprintf(out, "%-40s %12s %12s %10ld %10ld %10ld %10ld\n", label.c_str(),
+                 format_bytes(node.usage.max_rss_kb * 1024).c_str(), growth.c_str(), node.usage.minor_faults,
+                 node.usage.major_faults, node.usage.voluntary_switches, node.usage.involuntary_switches);
+  }
+
+  for (const auto &child : node.children) {
+    print_usage(out, *child, depth + 1);
+  }
+}
+
+/* self is what the scope allocated outside of its child scopes */
+void print_allocations(std::FILE *out, const ProfileNode &node, size_t depth) {
+  std::uint64_t self_allocations = node.allocations;
+  std::uint64_t self_bytes = node.allocated_bytes;
+  for (const auto &child : node.children) {
+    self_allocations -= std::min(self_allocations, child->allocations);
+    self_bytes -= std::min(self_bytes, child->allocated_bytes);
+  }
+
+  std::string label = std::string(depth * 2, ' ') + node.name;
+  std::fprintf(out, "%-40s %12lu %12s %12lu %12s %12s\n", label.c_str(), node.allocations,
+               format_bytes(static_cast<std::int64_t>(node.allocated_bytes)).c_str(), self_allocations,
+               format_bytes(static_cast<std::int64_t>(self_bytes)).c_str(), format_bytes(node.peak_live_bytes).c_str());
+
+  for (const auto &child : node.children) {
+    print_allocations(out, *child, depth + 1);
+  }
+}
+} // namespace
+
+ProfileNode *ProfileNode::child(std::string_view child_name) {
+  for (auto &c : children) {
+    if (c->name == child_name) {
+      return c.get();
+    }
+  }
+  auto &c = children.emplace_back(std::make_unique<ProfileNode>());
+  c->name = child_name;
+  c->parent = this;
+  return c.get();
+}
+
+void ProfileNode::merge(const ProfileNode &other) {
+  calls += other.calls;
+  total_ns += other.total_ns;
+  min_ns = std::min(min_ns, other.min_ns);
+  max_ns = std::max(max_ns, other.max_ns);
+  for (size_t event = 0; event < perf_event_count; ++event) {
+    counters[event] += other.counters[event];
+  }
+  counter_mask |= other.counter_mask;
+  allocations += other.allocations;
+  allocated_bytes += other.allocated_bytes;
+  peak_live_bytes = std::max(peak_live_bytes, other.peak_live_bytes);
+  if (other.has_usage) {
+    add_usage(ResourceUsage{}, other.usage);
+  }
+  peak_rss_growth_kb = std::max(peak_rss_growth_kb, other.peak_rss_growth_kb);
+  for (const auto &other_child : other.children) {
+    child(other_child->name)->merge(*other_child);
+  }
+}
+
+Profiler &Profiler::instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler() {
+  if (const char *env = std::getenv("AOC_PROFILE"); env != nullptr && std::strcmp(env, "0") == 0) {
+    report_at_exit = false;
+  }
+}
+
+Profiler::~Profiler() {
+  if (report_at_exit) {
+    report(stderr);
+  }
+}
+
+ProfileNode *Profiler::create_thread_root() {
+  std::lock_guard lock(roots_mutex);
+  return roots.emplace_back(std::make_unique<ProfileNode>()).get();
+}
+
+ProfileNode Profiler::merged() const {
+  ProfileNode result;
+  std::lock_guard lock(roots_mutex);
+  for (const auto &root : roots) {
+    result.merge(*root);
+  }
+  return result;
+}
+
+void Profiler::report(std::FILE *out) const {
+  ProfileNode tree = merged();
+  if (tree.children.empty()) {
+    return;
+  }
+
+  std::fprintf(out, "%-40s %8s %12s %12s %12s %12s %7s\n", "scope", "calls", "total", "avg", "min", "max", "share");
+  for (const auto &child : tree.children) {
+    print_node(out, *child, 0, 0);
+  }
+
+  if (tree_counter_mask(tree) != 0) {
+    std::fprintf(out, "\n%-40s %14s %14s %6s %10s %10s %10s\n", "scope", "cycles", "instructions", "IPC", "L1D/ki",
+                 "LLC/ki", "brmiss/ki");
+    for (const auto &child : tree.children) {
+      print_counters(out, *child, 0);
+    }
+  }
+
+  if (tree_has_usage(tree)) {
+    std::fprintf(out, "\n%-40s %12s %12s %10s %10s %10s %10s\n", "scope", "max RSS", "HWM growth", "minflt",
+                 "majflt", "vol cs", "invol cs");
+    for (const auto &child : tree.children) {
+      print_usage(out, *child, 0);
+    }
+  }
+
+  if (tree_allocations(tree) != 0) {
+    std::fprintf(out, "\n%-40s %12s %12s %12s %12s %12s\n", "scope", "allocs", "bytes", "self allocs", "self bytes",
+                 "peak live");
+    for (const auto &child : tree.children) {
+      print_allocations(out, *child, 0);
+    }
+  }
+}
+
+TimeIt::TimeIt(std::string_view name) {
+  if (current_node == nullptr) {
+    current_node = Profiler::instance().create_thread_root();
+  }
+  node = current_node->child(name);
+  current_node = node;
+  perf = PerfCounters::for_this_thread();
+  if (perf != nullptr && !perf->read(start_counters)) {
+    perf = nullptr;
+  }
+  trace = TraceRecorder::for_this_thread();
+  usage = resource_usage_enabled();
+  start_peak_rss_kb = -1;
+  counted_root = false;
+  root_generation = 0;
+  if (usage) {
+    /*
+     * /proc/self/status is too slow to read around every nested scope, and
+     * resetting VmHWM under a top level scope running on another thread
+     * would spoil its reading, so only a scope that opens alone does it.
+     */
+    if (node->parent->parent == nullptr) {
+      counted_root = true;
+      std::uint64_t before = root_scopes.fetch_add(root_opened + 1);
+      if ((before & roots_open_mask) == 0) {
+        root_generation = static_cast<std::uint32_t>(before >> 32) + 1;
+        reset_peak_rss();
+        start_peak_rss_kb = read_peak_rss_kb();
+      }
+    }
+    usage = read_resource_usage(start_usage);
+  }
+#ifdef AOC_ALLOC_TRACKING
+  /* Taken after child() so creating the node is not charged to it */
+  auto &allocations = thread_alloc_counters();
+  start_allocations = allocations;
+  allocations.peak_live_bytes = allocations.live_bytes;
+#endif
+  start_time = std::chrono::steady_clock::now();
+}
+
+TimeIt::~TimeIt() {
+  auto end_time = std::chrono::steady_clock::now();
+  perf_values_t end_counters;
+  bool has_counters = perf != nullptr && perf->read(end_counters);
+  if (has_counters) {
+    node->add_counters(start_counters, end_counters, perf->mask());
+  }
+  node->add_sample(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+  if (usage) {
+    ResourceUsage end_usage;
+    if (read_resource_usage(end_usage)) {
+      node->add_usage(start_usage, end_usage);
+    }
+  }
+  if (counted_root) {
+    std::int64_t end_peak_rss_kb = start_peak_rss_kb >= 0 ? read_peak_rss_kb() : -1;
+    /* Trusted only if no other top level scope opened while this one was open */
+    bool alone = static_cast<std::uint32_t>(root_scopes.fetch_sub(1) >> 32) == root_generation;
+    if (alone && start_peak_rss_kb >= 0 && end_peak_rss_kb >= 0) {
+      node->peak_rss_growth_kb = std::max(node->peak_rss_growth_kb, end_peak_rss_kb - start_peak_rss_kb);
+    }
+  }
+#ifdef AOC_ALLOC_TRACKING
+  auto &allocations = thread_alloc_counters();
+  node->add_allocations(start_allocations, allocations);
+  /* hand the enclosing scope the higher of its own and this scope's peak */
+  allocations.peak_live_bytes = std::max(allocations.peak_live_bytes, start_allocations.peak_live_bytes);
+#endif
+
+  if (trace != nullptr) {
+    const auto &recorder = TraceRecorder::instance();
+    TraceScope scope{};
+    scope.name = trace->intern(node->name);
+    for (const ProfileNode *ancestor = node->parent; ancestor->parent != nullptr; ancestor = ancestor->parent) {
+      ++scope.depth;
+    }
+    scope.begin_ns = recorder.since_start(start_time);
+    scope.end_ns = recorder.since_start(end_time);
+    if (has_counters) {
+      for (size_t event = 0; event < perf_event_count; ++event) {
+        scope.counters[event] = end_counters[event] - start_counters[event];
+      }
+      scope.counter_mask = perf->mask();
+    }
+#ifdef AOC_ALLOC_TRACKING
+    scope.has_live_bytes = true;
+    scope.live_bytes_begin = start_allocations.live_bytes;
+    scope.live_bytes_end = allocations.live_bytes;
+#endif
+    trace->add(scope);
+  }
+
+  current_node = node->parent;
+}
+
+std::string format_duration(std::uint64_t ns) {
+  char buffer[32];
+  if (ns < 1000) {
+    std::snprintf(buffer, sizeof(buffer), "%lu ns", ns);
+  } else if (ns < 1000000) {
+    std::snprintf(buffer, sizeof(buffer), "%.3f us", static_cast<double>(ns) / 1e3);
+  } else if (ns < 1000000000) {
+    std::snprintf(buffer, sizeof(buffer), "%.3f ms", static_cast<double>(ns) / 1e6);
+  } else {
+    std::snprintf(buffer, sizeof(buffer), "%.3f s", static_cast<double>(ns) / 1e9);
+  }
+  return buffer;
+}
+
+std::string format_bytes(std::int64_t bytes) {
+  char buffer[32];
+  auto value = static_cast<double>(bytes);
+  if (bytes < 1024 && bytes > -1024) {
+    std::snprintf(buffer, sizeof(buffer), "%ld B", bytes);
+  } else if (bytes < 1024 * 1024 && bytes > -1024 * 1024) {
+    std::snprintf(buffer, sizeof(buffer), "%.1f KiB", value / 1024);
+  } else if (bytes < 1024 * 1024 * 1024 && bytes > -1024 * 1024 * 1024) {
+    std::snprintf(buffer, sizeof(buffer), "%.1f MiB", value / (1024 * 1024));
+  } else {
+    std::snprintf(buffer, sizeof(buffer), "%.1f GiB", value / (1024 * 1024 * 1024));
+  }
+  return buffer;
+}
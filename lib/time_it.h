@@ -0,0 +1,149 @@
+#ifndef TIME_IT_H_B8VJ3LPA
+#define TIME_IT_H_B8VJ3LPA
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "alloc_tracking.h"
+#include "perf_counters.h"
+#include "resource_usage.h"
+#include "trace.h"
+
+/*
+ * One named scope in the profile tree. Repeated entries of the same scope
+ * under the same parent are aggregated into a single node.
+ */
+struct ProfileNode {
+  std::string name;
+  ProfileNode *parent = nullptr;
+  std::vector<std::unique_ptr<ProfileNode>> children;
+
+  std::uint64_t calls = 0;
+  std::uint64_t total_ns = 0;
+  std::uint64_t min_ns = std::numeric_limits<std::uint64_t>::max();
+  std::uint64_t max_ns = 0;
+
+  perf_values_t counters{};
+  perf_mask_t counter_mask = 0;
+
+  /* Heap use with AOC_ALLOC_TRACKING, children included like total_ns */
+  std::uint64_t allocations = 0;
+  std::uint64_t allocated_bytes = 0;
+  std::int64_t peak_live_bytes = 0;
+
+  /*
+   * With AOC_RUSAGE, faults and context switches summed over calls and the
+   * highest max RSS seen. VmHWM is process wide, so its growth is only
+   * sampled for a top level scope that no other thread's top level scope
+   * overlapped, and stays -1 (printed "-") when no call ran alone.
+   */
+  bool has_usage = false;
+  ResourceUsage usage{};
+  std::int64_t peak_rss_growth_kb = -1;
+
+  [[nodiscard]] ProfileNode *child(std::string_view child_name);
+
+  void add_sample(std::uint64_t ns) noexcept {
+    ++calls;
+    total_ns += ns;
+    min_ns = std::min(min_ns, ns);
+    max_ns = std::max(max_ns, ns);
+  }
+
+  void add_counters(const perf_values_t &start, const perf_values_t &end, perf_mask_t mask) noexcept {
+    for (size_t event = 0; event < perf_event_count; ++event) {
+      counters[event] += end[event] - start[event];
+    }
+    counter_mask |= mask;
+  }
+
+  void add_allocations(const AllocCounters &start, const AllocCounters &end) noexcept {
+    allocations += end.allocations - start.allocations;
+    allocated_bytes += end.bytes - start.bytes;
+    peak_live_bytes = std::max(peak_live_bytes, end.peak_live_bytes - start.live_bytes);
+  }
+
+  void add_usage(const ResourceUsage &start, const ResourceUsage &end) noexcept {
+    has_usage = true;
+    usage.max_rss_kb = std::max(usage.max_rss_kb, end.max_rss_kb);
+    usage.minor_faults += end.minor_faults - start.minor_faults;
+    usage.major_faults += end.major_faults - start.major_faults;
+    usage.voluntary_switches += end.voluntary_switches - start.voluntary_switches;
+    usage.involuntary_switches += end.involuntary_switches - start.involuntary_switches;
+  }
+
+  void merge(const ProfileNode &other);
+};
+
+/*
+ * Owns one profile tree per thread that ever opened a TimeIt scope and
+ * prints the merged tree when the program exits.
+ */
+class Profiler {
+public:
+  [[nodiscard]] static Profiler &instance();
+
+  [[nodiscard]] ProfileNode *create_thread_root();
+
+  [[nodiscard]] ProfileNode merged() const;
+
+  void report(std::FILE *out) const;
+
+  void set_report_at_exit(bool enabled) noexcept { report_at_exit = enabled; }
+
+  ~Profiler();
+
+private:
+  Profiler();
+
+  mutable std::mutex roots_mutex;
+  std::vector<std::unique_ptr<ProfileNode>> roots;
+  bool report_at_exit = true;
+};
+
+/*
+ * Scoped timer on steady_clock. Scopes nest per thread, so a TimeIt opened
+ * while another one is alive on the same thread shows up as its child in the
+ * summary printed at exit. Set AOC_PROFILE=0 to silence the summary and
+ * AOC_PERF=1 to also count cycles, instructions and misses per scope. Heap
+ * allocations are counted per scope when built with AOC_ALLOC_TRACKING.
+ * AOC_TRACE=file.json records every scope as a trace event, see trace.h.
+ * AOC_RUSAGE=1 adds page faults, context switches and peak RSS per scope;
+ * the HWM growth column reads "-" for top level scopes that always ran
+ * alongside another thread's, as in aoc_all or aoc_service.
+ */
+struct TimeIt {
+  ProfileNode *node;
+  PerfCounters *perf;
+  TraceBuffer *trace;
+  perf_values_t start_counters;
+  AllocCounters start_allocations;
+  bool usage;
+  ResourceUsage start_usage;
+  std::int64_t start_peak_rss_kb;
+  /* Counted in the process wide open top level scopes, see time_it.cpp */
+  bool counted_root;
+  /* Top level scopes opened before this one and itself, 0 unless it reset VmHWM */
+  std::uint32_t root_generation;
+  std::chrono::steady_clock::time_point start_time;
+
+  TimeIt(std::string_view name);
+
+  TimeIt(const TimeIt &) = delete;
+  TimeIt &operator=(const TimeIt &) = delete;
+
+  ~TimeIt();
+};
+
+[[nodiscard]] std::string format_duration(std::uint64_t ns);
+
+[[nodiscard]] std::string format_bytes(std::int64_t bytes);
+
+#endif /* end of include guard: TIME_IT_H_B8VJ3LPA */
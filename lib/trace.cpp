@@ -0,0 +1,141 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "json.h"
+
+namespace {
+/* Trace timestamps are microseconds, keep the nanoseconds as decimals */
+[[nodiscard]] double to_us(std::uint64_t ns) noexcept {
+  return static_cast<double>(ns) / 1e3;
+}
+} // namespace
+
+std::uint32_t TraceBuffer::intern(std::string_view name) {
+  if (auto it = name_ids.find(name); it != name_ids.end()) {
+    return it->second;
+  }
+  auto id = static_cast<std::uint32_t>(names.size());
+  names.emplace_back(name);
+  name_ids.emplace(names.back(), id);
+  return id;
+}
+
+TraceRecorder &TraceRecorder::instance() {
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+TraceRecorder::TraceRecorder() : start(std::chrono::steady_clock::now()) {
+  if (const char *env = std::getenv("AOC_TRACE"); env != nullptr) {
+    output_path = env;
+  }
+}
+
+TraceRecorder::~TraceRecorder() {
+  if (!enabled()) {
+    return;
+  }
+  std::FILE *out = std::fopen(output_path.c_str(), "w");
+  if (out == nullptr) {
+    std::fprintf(stderr, "AOC_TRACE: cannot write %s\n", output_path.c_str());
+    return;
+  }
+  write(out);
+  std::fclose(out);
+}
+
+TraceBuffer *TraceRecorder::for_this_thread() {
+  if (!instance().enabled()) {
+    return nullptr;
+  }
+  thread_local TraceBuffer *buffer = instance().create_buffer();
+  return buffer;
+}
+
+TraceBuffer *TraceRecorder::create_buffer() {
+  std::lock_guard lock(buffers_mutex);
+  auto index = static_cast<std::uint32_t>(buffers.size());
+  return buffers.emplace_back(std::make_unique<TraceBuffer>(index, static_cast<long>(::syscall(SYS_gettid)))).get();
+}
+
+void TraceRecorder::write(std::FILE *out) const {
+  std::lock_guard lock(buffers_mutex);
+  long pid = static_cast<long>(::getpid());
+  const char *separator = "\n";
+  auto begin_event = [&] {
+    std::fputs(separator, out);
+    separator = ",\n";
+  };
+
+  std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  begin_event();
+  std::fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"args\":{\"name\":\"aoc\"}}", pid);
+
+  /* +1 when a thread enters a top level scope, -1 when it leaves */
+  std::vector<std::pair<std::uint64_t, int>> busy_changes;
+
+  for (const auto &buffer : buffers) {
+    std::string thread_name =
+      buffer->os_tid == pid ? std::string("main") : "thread " + std::to_string(buffer->index);
+    begin_event();
+    std::fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"name\":", pid,
+                 buffer->os_tid);
+    write_json_string(out, thread_name);
+    std::fprintf(out, "}}");
+
+    std::string heap_track = "live heap (" + thread_name + ")";
+    for (const TraceScope &scope : buffer->scopes) {
+      begin_event();
+      std::fprintf(out, "{\"name\":");
+      write_json_string(out, buffer->names[scope.name]);
+      std::fprintf(out, ",\"cat\":\"scope\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f", pid,
+                   buffer->os_tid, to_us(scope.begin_ns), to_us(scope.end_ns - scope.begin_ns));
+      if (scope.counter_mask != 0) {
+        std::fprintf(out, ",\"args\":{");
+        const char *arg_separator = "";
+        for (size_t event = 0; event < perf_event_count; ++event) {
+          if ((scope.counter_mask & (1u << event)) != 0) {
+            std::fprintf(out, "%s", arg_separator);
+            write_json_string(out, perf_event_name(event));
+            std::fprintf(out, ":%lu", scope.counters[event]);
+            arg_separator = ",";
+          }
+        }
+        std::fprintf(out, "}");
+      }
+      std::fprintf(out, "}");
+
+      if (scope.has_live_bytes) {
+        for (auto [ns, bytes] : {std::pair{scope.begin_ns, scope.live_bytes_begin},
+                                 std::pair{scope.end_ns, scope.live_bytes_end}}) {
+          begin_event();
+          std::fprintf(out, "{\"name\":");
+          write_json_string(out, heap_track);
+          std::fprintf(out, ",\"ph\":\"C\",\"pid\":%ld,\"ts\":%.3f,\"args\":{\"bytes\":%ld}}", pid, to_us(ns), bytes);
+        }
+      }
+
+      if (scope.depth == 0) {
+        busy_changes.emplace_back(scope.begin_ns, 1);
+        busy_changes.emplace_back(scope.end_ns, -1);
+      }
+    }
+  }
+
+  std::sort(busy_changes.begin(), busy_changes.end());
+  int busy = 0;
+  for (auto [ns, change] : busy_changes) {
+    busy += change;
+    begin_event();
+    std::fprintf(out, "{\"name\":\"busy threads\",\"ph\":\"C\",\"pid\":%ld,\"ts\":%.3f,\"args\":{\"threads\":%d}}",
+                 pid, to_us(ns), busy);
+  }
+
+  std::fprintf(out, "\n]}\n");
+}
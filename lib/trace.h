@@ -0,0 +1,93 @@
+#ifndef TRACE_H_H5XK0RBM
+#define TRACE_H_H5XK0RBM
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "perf_counters.h"
+
+/* One finished TimeIt scope as recorded for the trace */
+struct TraceScope {
+  std::uint32_t name;
+  std::uint32_t depth;
+  std::uint64_t begin_ns;
+  std::uint64_t end_ns;
+  perf_values_t counters;
+  perf_mask_t counter_mask;
+  bool has_live_bytes;
+  std::int64_t live_bytes_begin;
+  std::int64_t live_bytes_end;
+};
+
+/*
+ * Scopes finished on one thread, appended without locking since only that
+ * thread writes to it. Names are interned so each event stays small.
+ */
+class TraceBuffer {
+public:
+  TraceBuffer(std::uint32_t index, long os_tid) : index(index), os_tid(os_tid) {}
+
+  [[nodiscard]] std::uint32_t intern(std::string_view name);
+
+  void add(const TraceScope &scope) { scopes.push_back(scope); }
+
+private:
+  friend class TraceRecorder;
+
+  struct NameHash {
+    using is_transparent = void;
+    [[nodiscard]] size_t operator()(std::string_view name) const noexcept { return std::hash<std::string_view>{}(name); }
+  };
+
+  std::uint32_t index;
+  long os_tid;
+  std::vector<std::string> names;
+  std::unordered_map<std::string, std::uint32_t, NameHash, std::equal_to<>> name_ids;
+  std::vector<TraceScope> scopes;
+};
+
+/*
+ * Collects every TimeIt scope of every thread when AOC_TRACE names an output
+ * file and writes them there at exit as Chrome trace event JSON, readable by
+ * chrome://tracing and ui.perfetto.dev. Each scope becomes a complete event
+ * on its thread's track with its hardware counters as arguments. Counter
+ * tracks show how many threads are inside a top level scope at any time and,
+ * with AOC_ALLOC_TRACKING, each thread's live heap.
+ */
+class TraceRecorder {
+public:
+  [[nodiscard]] static TraceRecorder &instance();
+
+  /* nullptr when tracing is off */
+  [[nodiscard]] static TraceBuffer *for_this_thread();
+
+  [[nodiscard]] bool enabled() const noexcept { return !output_path.empty(); }
+
+  [[nodiscard]] std::uint64_t since_start(std::chrono::steady_clock::time_point time) const noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - start).count());
+  }
+
+  void write(std::FILE *out) const;
+
+  ~TraceRecorder();
+
+private:
+  TraceRecorder();
+
+  [[nodiscard]] TraceBuffer *create_buffer();
+
+  std::string output_path;
+  std::chrono::steady_clock::time_point start;
+
+  mutable std::mutex buffers_mutex;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+#endif /* end of include guard: TRACE_H_H5XK0RBM */